@@ -649,6 +649,17 @@ ifeq ($(strip $(DYNAMIC_KEYMAP_ENABLE)), yes)
     SEND_STRING_ENABLE := yes
 endif
 
+ifeq ($(strip $(SEND_STRING_ASYNC_ENABLE)), yes)
+    SEND_STRING_ENABLE := yes
+    DEFERRED_EXEC_ENABLE := yes
+    EVENT_QUEUE_ENABLE := yes
+    OPT_DEFS += -DSEND_STRING_ASYNC_ENABLE
+endif
+
+ifeq ($(strip $(DYNAMIC_COMBO_ENABLE)), yes)
+    COMBO_ENABLE := yes
+endif
+
 VALID_CUSTOM_MATRIX_TYPES:= yes lite no
 
 CUSTOM_MATRIX ?= no
@@ -19,6 +19,7 @@ SEND_STRING_ENABLE ?= yes
 SPACE_CADET_ENABLE ?= yes
 
 GENERIC_FEATURES = \
+    ACTION_TABLE \
     AUTO_SHIFT \
     AUTOCORRECT \
     BATTERY \
@@ -31,20 +32,25 @@ GENERIC_FEATURES = \
     DEFERRED_EXEC \
     DIGITIZER \
     DIP_SWITCH \
+    DYNAMIC_COMBO \
     DYNAMIC_KEYMAP \
     DYNAMIC_MACRO \
     DYNAMIC_TAPPING_TERM \
+    EVENT_QUEUE \
     GRAVE_ESC \
     HAPTIC \
     KEYCODE_STRING \
     KEY_LOCK \
     KEY_OVERRIDE \
+    LATENCY_TRACER \
     LAYER_LOCK \
     LEADER \
     MAGIC \
+    MATRIX_INTERRUPT \
     MOUSEKEY \
     MUSIC \
     OS_DETECTION \
+    PROFILING \
     PROGRAMMABLE_BUTTON \
     REPEAT_KEY \
     SECURE \
@@ -53,6 +59,7 @@ GENERIC_FEATURES = \
     SPACE_CADET \
     SWAP_HANDS \
     TAP_DANCE \
+    TASK_SCHEDULER \
     TRI_LAYER \
     VIA \
     VIRTSER \
@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "keycode_config.h"
 #include "debug.h"
 #include "quantum.h"
+#include "latency_tracer.h"
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
@@ -81,6 +82,7 @@ void action_exec(keyevent_t event) {
         ac_dprintf("EVENT: ");
         debug_event(event);
         ac_dprintf("\n");
+        latency_tracer_action_exec(event);
 #if defined(RETRO_TAPPING) || defined(RETRO_TAPPING_PER_KEY) || (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT))
         uint16_t event_keycode = get_event_keycode(event, false);
         if (event.pressed) {
@@ -53,8 +53,24 @@ typedef struct keyrecord_t {
 #if defined(COMBO_ENABLE) || defined(REPEAT_KEY_ENABLE)
     uint16_t keycode;
 #endif
+#ifdef RECORD_KEYCODE_CACHE
+    struct {
+        uint16_t keycode;
+        uint16_t layer_generation; // Layer state it was resolved under, see layer_state_generation
+        bool     valid : 1;
+        bool     pressed : 1;
+        bool     updated : 1; // Also valid for lookups that update the source layers cache
+    } keycode_cache;
+#endif
 } keyrecord_t;
 
+#ifdef RECORD_KEYCODE_CACHE
+/* Forget the keycode looked up for a record */
+void clear_record_keycode_cache(keyrecord_t *record);
+#else
+#    define clear_record_keycode_cache(record)
+#endif
+
 /* Execute action per keyevent */
 void action_exec(keyevent_t event);
 
@@ -1,16 +1,22 @@
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "keyboard.h"
 #include "action.h"
 #include "encoder.h"
 #include "util.h"
 #include "action_layer.h"
+#include "source_layers_cache.h"
 
 /** \brief Default Layer State
  */
 layer_state_t default_layer_state = 0;
 
+#ifdef RECORD_KEYCODE_CACHE
+uint16_t layer_state_generation = 0;
+#endif
+
 /** \brief Default Layer State Set At user Level
  *
  * Run user code on default layer state change
@@ -46,6 +52,9 @@ static void default_layer_state_set(layer_state_t state) {
     default_layer_debug();
     ac_dprintf(" to ");
     default_layer_state = state;
+#ifdef RECORD_KEYCODE_CACHE
+    layer_state_generation++;
+#endif
     default_layer_debug();
     ac_dprintf("\n");
 #if defined(STRICT_LAYER_RELEASE)
@@ -136,6 +145,9 @@ void layer_state_set(layer_state_t state) {
     layer_debug();
     ac_dprintf(" to ");
     layer_state = state;
+#    ifdef RECORD_KEYCODE_CACHE
+    layer_state_generation++;
+#    endif
     layer_debug();
     ac_dprintf("\n");
 #    if defined(STRICT_LAYER_RELEASE)
@@ -237,41 +249,15 @@ void layer_debug(void) {
 
 #if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
 /** \brief source layer cache
+ *
+ * Storage layout is selected in source_layers_cache.h
  */
 
-uint8_t source_layers_cache[((MATRIX_ROWS * MATRIX_COLS) + (CHAR_BIT)-1) / (CHAR_BIT)][MAX_LAYER_BITS] = {{0}};
+uint8_t source_layers_cache[SOURCE_LAYERS_CACHE_SIZE(MATRIX_ROWS * MATRIX_COLS)] = {0};
 #    ifdef ENCODER_MAP_ENABLE
-uint8_t encoder_source_layers_cache[(NUM_ENCODERS + (CHAR_BIT)-1) / (CHAR_BIT)][MAX_LAYER_BITS] = {{0}};
+uint8_t encoder_source_layers_cache[SOURCE_LAYERS_CACHE_SIZE(NUM_ENCODERS)] = {0};
 #    endif // ENCODER_MAP_ENABLE
 
-/** \brief update source layers cache impl
- *
- * Updates the supplied cache when changing layers
- */
-void update_source_layers_cache_impl(uint8_t layer, uint16_t entry_number, uint8_t cache[][MAX_LAYER_BITS]) {
-    const uint16_t storage_idx = entry_number / (CHAR_BIT);
-    const uint8_t  storage_bit = entry_number % (CHAR_BIT);
-    for (uint8_t bit_number = 0; bit_number < MAX_LAYER_BITS; bit_number++) {
-        cache[storage_idx][bit_number] ^= (-((layer & (1U << bit_number)) != 0) ^ cache[storage_idx][bit_number]) & (1U << storage_bit);
-    }
-}
-
-/** \brief read source layers cache
- *
- * reads the cached keys stored when the layer was changed
- */
-uint8_t read_source_layers_cache_impl(uint16_t entry_number, uint8_t cache[][MAX_LAYER_BITS]) {
-    const uint16_t storage_idx = entry_number / (CHAR_BIT);
-    const uint8_t  storage_bit = entry_number % (CHAR_BIT);
-    uint8_t        layer       = 0;
-
-    for (uint8_t bit_number = 0; bit_number < MAX_LAYER_BITS; bit_number++) {
-        layer |= ((cache[storage_idx][bit_number] & (1U << storage_bit)) != 0) << bit_number;
-    }
-
-    return layer;
-}
-
 /** \brief update encoder source layers cache
  *
  * Updates the cached encoders when changing layers
@@ -279,12 +265,12 @@ uint8_t read_source_layers_cache_impl(uint16_t entry_number, uint8_t cache[][MAX
 void update_source_layers_cache(keypos_t key, uint8_t layer) {
     if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
         const uint16_t entry_number = (uint16_t)(key.row * MATRIX_COLS) + key.col;
-        update_source_layers_cache_impl(layer, entry_number, source_layers_cache);
+        source_layers_cache_update(source_layers_cache, entry_number, layer);
     }
 #    ifdef ENCODER_MAP_ENABLE
     else if (key.row == KEYLOC_ENCODER_CW || key.row == KEYLOC_ENCODER_CCW) {
         const uint16_t entry_number = key.col;
-        update_source_layers_cache_impl(layer, entry_number, encoder_source_layers_cache);
+        source_layers_cache_update(encoder_source_layers_cache, entry_number, layer);
     }
 #    endif // ENCODER_MAP_ENABLE
 }
@@ -296,12 +282,12 @@ void update_source_layers_cache(keypos_t key, uint8_t layer) {
 uint8_t read_source_layers_cache(keypos_t key) {
     if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
         const uint16_t entry_number = (uint16_t)(key.row * MATRIX_COLS) + key.col;
-        return read_source_layers_cache_impl(entry_number, source_layers_cache);
+        return source_layers_cache_read(source_layers_cache, entry_number);
     }
 #    ifdef ENCODER_MAP_ENABLE
     else if (key.row == KEYLOC_ENCODER_CW || key.row == KEYLOC_ENCODER_CCW) {
         const uint16_t entry_number = key.col;
-        return read_source_layers_cache_impl(entry_number, encoder_source_layers_cache);
+        return source_layers_cache_read(encoder_source_layers_cache, entry_number);
     }
 #    endif // ENCODER_MAP_ENABLE
     return 0;
@@ -335,6 +321,28 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_RESOLUTION_CACHE)
+/** \brief resolved layers cache
+ *
+ * Topmost non-transparent layer of each key, valid while its generation matches and the layer state is unchanged
+ */
+static uint8_t       resolved_layers[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t       resolved_generation[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t       current_generation    = 1;
+static layer_state_t resolved_layers_state = 0;
+
+/** \brief clear resolved layers cache
+ *
+ * Invalidates every entry at once, the generation wrapping around is the only time the cache is walked
+ */
+void clear_resolved_layers_cache(void) {
+    if (++current_generation == 0) {
+        memset(resolved_generation, 0, sizeof(resolved_generation));
+        current_generation = 1;
+    }
+}
+#endif
+
 /** \brief Layer switch get layer
  *
  * Gets the layer based on key info
@@ -345,17 +353,37 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     action.code = ACTION_TRANSPARENT;
 
     layer_state_t layers = layer_state | default_layer_state;
-    /* check top layer first */
+
+#    ifdef LAYER_RESOLUTION_CACHE
+    const bool cacheable = key.row < MATRIX_ROWS && key.col < MATRIX_COLS;
+    if (layers != resolved_layers_state) {
+        clear_resolved_layers_cache();
+        resolved_layers_state = layers;
+    }
+    if (cacheable && resolved_generation[key.row][key.col] == current_generation) {
+        return resolved_layers[key.row][key.col];
+    }
+#    endif
+
+    /* check top layer first, fall back to layer 0 */
+    uint8_t layer = 0;
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
             action = action_for_key(i, key);
             if (action.code != ACTION_TRANSPARENT) {
-                return i;
+                layer = i;
+                break;
             }
         }
     }
-    /* fall back to layer 0 */
-    return 0;
+
+#    ifdef LAYER_RESOLUTION_CACHE
+    if (cacheable) {
+        resolved_layers[key.row][key.col]     = layer;
+        resolved_generation[key.row][key.col] = current_generation;
+    }
+#    endif
+    return layer;
 #else
     return get_highest_layer(default_layer_state);
 #endif
@@ -75,6 +75,9 @@ typedef uint32_t layer_state_t;
  * Default Layer
  */
 extern layer_state_t default_layer_state;
+#ifdef RECORD_KEYCODE_CACHE
+extern uint16_t layer_state_generation; // Changes every time the layer state or the default layer state is set
+#endif
 void                 default_layer_debug(void);
 void                 default_layer_set(layer_state_t state);
 
@@ -169,5 +172,12 @@ action_t store_or_get_action(bool pressed, keypos_t key);
 /* return the topmost non-transparent layer currently associated with key */
 uint8_t layer_switch_get_layer(keypos_t key);
 
+/* resolved layers cache, must be cleared whenever a keymap entry changes */
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_RESOLUTION_CACHE)
+void clear_resolved_layers_cache(void);
+#else
+#    define clear_resolved_layers_cache()
+#endif
+
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
@@ -0,0 +1,48 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <limits.h>
+#include <string.h>
+#include "action_table.h"
+#include "keycode_config.h"
+#include "keymap_common.h"
+#include "matrix.h"
+
+#define ACTION_TABLE_KEYS (MATRIX_ROWS * MATRIX_COLS)
+
+static action_t actions[ACTION_TABLE_LAYERS][ACTION_TABLE_KEYS];
+static uint8_t  valid[ACTION_TABLE_LAYERS][(ACTION_TABLE_KEYS + (CHAR_BIT)-1) / (CHAR_BIT)];
+static uint16_t valid_keymap_config;
+
+action_t action_table_action_for_key(uint8_t layer, keypos_t key) {
+    if (layer >= ACTION_TABLE_LAYERS || key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+        return action_for_keycode(keymap_key_to_keycode(layer, key));
+    }
+
+    // Swaps change the translation of almost every key
+    if (keymap_config.raw != valid_keymap_config) {
+        action_table_invalidate();
+        valid_keymap_config = keymap_config.raw;
+    }
+
+    const uint16_t index = key.row * MATRIX_COLS + key.col;
+    const uint8_t  mask  = 1U << (index % (CHAR_BIT));
+    if (!(valid[layer][index / (CHAR_BIT)] & mask)) {
+        actions[layer][index] = action_for_keycode(keymap_key_to_keycode(layer, key));
+        valid[layer][index / (CHAR_BIT)] |= mask;
+    }
+    return actions[layer][index];
+}
+
+void action_table_invalidate(void) {
+    memset(valid, 0, sizeof(valid));
+}
+
+void action_table_invalidate_key(uint8_t layer, uint8_t row, uint8_t col) {
+    if (layer >= ACTION_TABLE_LAYERS || row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+        return;
+    }
+
+    const uint16_t index = row * MATRIX_COLS + col;
+    valid[layer][index / (CHAR_BIT)] &= ~(1U << (index % (CHAR_BIT)));
+}
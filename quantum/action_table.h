@@ -0,0 +1,65 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup action_table Action Table API
+ *
+ * \brief Precomputed actions for the keys of the lower keymap layers.
+ *
+ * Translating a keycode into an action goes through a large `switch` and the
+ * magic keycode remapping. The action table holds the translated action of
+ * every matrix position on the first `ACTION_TABLE_LAYERS` layers, so that
+ * looking up a key only costs a bounds check and an array read.
+ *
+ * Entries are translated from the keymap the first time they are needed.
+ * They are kept until the keymap or `keymap_config` changes: the keymap
+ * config is checked on every lookup, while code that changes the keymap at
+ * runtime (such as dynamic keymaps) must invalidate the entries it touches.
+ * Higher layers, encoders and other virtual key positions always fall back
+ * to translating the keycode.
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include "action.h"
+
+// Each layer costs a little over two bytes of RAM per key, which AVR can't spare
+#ifndef ACTION_TABLE_LAYERS
+#    ifdef __AVR__
+#        define ACTION_TABLE_LAYERS 1
+#    else
+#        define ACTION_TABLE_LAYERS 4
+#    endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Look up the action of a key, translating and storing it if needed
+ */
+action_t action_table_action_for_key(uint8_t layer, keypos_t key);
+
+/** \brief Drop every entry, so that they are translated again from the keymap
+ */
+void action_table_invalidate(void);
+
+/** \brief Drop the entry of a single key, after its keycode changed
+ */
+void action_table_invalidate_key(uint8_t layer, uint8_t row, uint8_t col);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifndef ACTION_TABLE_ENABLE
+#    define action_table_invalidate()
+#    define action_table_invalidate_key(layer, row, col)
+#endif
+
+/** \} */
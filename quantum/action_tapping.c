@@ -1,11 +1,13 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "action.h"
 #include "action_layer.h"
 #include "action_tapping.h"
 #include "action_util.h"
 #include "keycode.h"
+#include "matrix.h"
 #include "quantum_keycodes.h"
 #include "timer.h"
 
@@ -22,7 +24,11 @@
 #    else
 #        define IS_TAPPING_RECORD(r) (KEYEQ(tapping_key.event.key, (r->event.key)) && tapping_key.keycode == r->keycode)
 #    endif
-#    define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < GET_TAPPING_TERM(get_record_keycode(&tapping_key, false), &tapping_key))
+#    ifdef TAPPING_TERM_PER_KEY
+#        define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < get_tapping_key_term())
+#    else
+#        define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < GET_TAPPING_TERM(get_record_keycode(&tapping_key, false), &tapping_key))
+#    endif
 #    define WITHIN_QUICK_TAP_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < GET_QUICK_TAP_TERM(get_record_keycode(&tapping_key, false), &tapping_key))
 
 #    ifdef DYNAMIC_TAPPING_TERM_ENABLE
@@ -114,9 +120,38 @@ static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
 static uint8_t     waiting_buffer_tail                 = 0;
+static uint16_t    waiting_buffer_overflows            = 0;
+
+// Index of the buffered events: which matrix keys have a press or a release
+// waiting, and how many presses are waiting in total.
+static matrix_row_t waiting_buffer_presses[MATRIX_ROWS]  = {};
+static matrix_row_t waiting_buffer_releases[MATRIX_ROWS] = {};
+static uint8_t      waiting_buffer_pressed_count         = 0;
+
+#    ifdef TAPPING_TERM_PER_KEY
+// get_tapping_term() of tapping_key, evaluated once per tapping key.
+static uint16_t tapping_key_term       = 0;
+static bool     tapping_key_term_valid = false;
+
+static uint16_t get_tapping_key_term(void) {
+    if (!tapping_key_term_valid) {
+        tapping_key_term       = GET_TAPPING_TERM(get_record_keycode(&tapping_key, false), &tapping_key);
+        tapping_key_term_valid = true;
+    }
+    return tapping_key_term;
+}
+#    endif
+
+static inline void set_tapping_key(keyrecord_t record) {
+    tapping_key = record;
+#    ifdef TAPPING_TERM_PER_KEY
+    tapping_key_term_valid = false;
+#    endif
+}
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_pop(void);
 static void waiting_buffer_clear(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
@@ -135,13 +170,32 @@ void action_tapping_process(keyrecord_t record) {
             debug_record(record);
             ac_dprintf("\n");
         }
-    } else {
+    } else if (!waiting_buffer_enq(record)) {
+        if (waiting_buffer_overflows < UINT16_MAX) {
+            waiting_buffer_overflows++;
+        }
+
+        // The buffer can only fill up behind a tapping key: settle it as it
+        // stands, as a timeout would, so that the buffered events can go.
+        ac_dprintf("OVERFLOW: SETTLE TAPPING KEY\n");
+        if (tapping_key.event.pressed && tapping_key.tap.count == 0) {
+            process_record(&tapping_key);
+            set_tapping_key((keyrecord_t){0});
+        } else if (!tapping_key.event.pressed) {
+            set_tapping_key((keyrecord_t){0});
+        }
+        for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_pop()) {
+            if (!process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+                break;
+            }
+        }
+
         if (!waiting_buffer_enq(record)) {
-            // clear all in case of overflow.
+            // clear all if nothing could be processed.
             ac_dprintf("OVERFLOW: CLEAR ALL STATES\n");
             clear_keyboard();
             waiting_buffer_clear();
-            tapping_key = (keyrecord_t){0};
+            set_tapping_key((keyrecord_t){0});
         }
     }
 
@@ -149,7 +203,7 @@ void action_tapping_process(keyrecord_t record) {
     if (IS_EVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         ac_dprintf("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_pop()) {
         if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
             ac_dprintf("processed: waiting_buffer[%u] =", waiting_buffer_tail);
             debug_record(waiting_buffer[waiting_buffer_tail]);
@@ -253,7 +307,7 @@ bool process_tapping(keyrecord_t *keyp) {
 #    endif // defined(FLOW_TAP_TERM)
 
             ac_dprintf("Tapping: Start(Press tap key).\n");
-            tapping_key = *keyp;
+            set_tapping_key(*keyp);
             process_record_tap_hint(&tapping_key);
             waiting_buffer_scan_tap();
             debug_tapping_key();
@@ -293,7 +347,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     // Now that tapping_key has settled as tapped, check whether
                     // Flow Tap applies to following yet-unsettled keys.
                     uint16_t prev_time = tapping_key.event.time;
-                    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+                    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_pop()) {
                         keyrecord_t *record = &waiting_buffer[waiting_buffer_tail];
                         if (!record->event.pressed) {
                             break;
@@ -322,7 +376,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     tapping_key.tap.count = 1;
                     registered_taps_add(tapping_key.event.key);
                     process_record(&tapping_key);
-                    tapping_key = (keyrecord_t){0};
+                    set_tapping_key((keyrecord_t){0});
 
                     waiting_buffer_chordal_hold_taps_until(event.key);
                     debug_registered_taps();
@@ -353,7 +407,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     uint8_t first_tap = waiting_buffer_find_chordal_hold_tap();
                     ac_dprintf("first_tap = %u\n", first_tap);
                     if (first_tap < WAITING_BUFFER_SIZE) {
-                        for (; waiting_buffer_tail != first_tap; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+                        for (; waiting_buffer_tail != first_tap; waiting_buffer_pop()) {
                             ac_dprintf("Processing [%u]\n", waiting_buffer_tail);
                             process_record(&waiting_buffer[waiting_buffer_tail]);
                         }
@@ -364,7 +418,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     debug_waiting_buffer();
 #    endif // CHORDAL_HOLD
 
-                    tapping_key = (keyrecord_t){0};
+                    set_tapping_key((keyrecord_t){0});
                     debug_tapping_key();
                     // enqueue
                     return false;
@@ -433,7 +487,7 @@ bool process_tapping(keyrecord_t *keyp) {
                                 registered_taps_add(tapping_key.event.key);
                                 debug_registered_taps();
                                 process_record(&tapping_key);
-                                tapping_key = (keyrecord_t){0};
+                                set_tapping_key((keyrecord_t){0});
                             }
                         } else
 #    endif // CHORDAL_HOLD
@@ -451,14 +505,14 @@ bool process_tapping(keyrecord_t *keyp) {
 
 #    if defined(CHORDAL_HOLD)
                             if (waiting_buffer_tail != waiting_buffer_head && is_tap_record(&waiting_buffer[waiting_buffer_tail])) {
-                                tapping_key = waiting_buffer[waiting_buffer_tail];
+                                set_tapping_key(waiting_buffer[waiting_buffer_tail]);
                                 // Pop tail from the queue.
-                                waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+                                waiting_buffer_pop();
                                 debug_waiting_buffer();
                             } else
 #    endif // CHORDAL_HOLD
                             {
-                                tapping_key = (keyrecord_t){0};
+                                set_tapping_key((keyrecord_t){0});
                             }
                             debug_tapping_key();
 
@@ -477,7 +531,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     ac_dprintf("Tapping: Tap release(%u)\n", tapping_key.tap.count);
                     keyp->tap = tapping_key.tap;
                     process_record(keyp);
-                    tapping_key = *keyp;
+                    set_tapping_key(*keyp);
                     debug_tapping_key();
                     return true;
                 } else if (is_tap_record(keyp) && event.pressed) {
@@ -497,7 +551,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     } else {
                         ac_dprintf("Tapping: Start while last tap(1).\n");
                     }
-                    tapping_key = *keyp;
+                    set_tapping_key(*keyp);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -518,7 +572,7 @@ bool process_tapping(keyrecord_t *keyp) {
                 debug_event(event);
                 ac_dprintf("\n");
                 process_record(&tapping_key);
-                tapping_key = (keyrecord_t){0};
+                set_tapping_key((keyrecord_t){0});
                 debug_tapping_key();
                 return false;
             } else {
@@ -529,7 +583,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     ac_dprintf("Tapping: End. last timeout tap release(>0).");
                     keyp->tap = tapping_key.tap;
                     process_record(keyp);
-                    tapping_key = (keyrecord_t){0};
+                    set_tapping_key((keyrecord_t){0});
                     return true;
                 } else if (is_tap_record(keyp) && event.pressed) {
                     if (tapping_key.tap.count > 1) {
@@ -548,7 +602,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     } else {
                         ac_dprintf("Tapping: Start while last timeout tap(1).\n");
                     }
-                    tapping_key = *keyp;
+                    set_tapping_key(*keyp);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -575,24 +629,24 @@ bool process_tapping(keyrecord_t *keyp) {
                         if (keyp->tap.count < 15) keyp->tap.count += 1;
                         ac_dprintf("Tapping: Tap press(%u)\n", keyp->tap.count);
                         process_record(keyp);
-                        tapping_key = *keyp;
+                        set_tapping_key(*keyp);
                         debug_tapping_key();
                         return true;
                     }
                     // FIX: start new tap again
-                    tapping_key = *keyp;
+                    set_tapping_key(*keyp);
                     return true;
                 } else if (is_tap_record(keyp)) {
                     // Sequential tap can be interfered with other tap key.
 #    if defined(FLOW_TAP_TERM)
                     if (flow_tap_key_if_within_term(keyp, flow_tap_prev_time)) {
-                        tapping_key = (keyrecord_t){0};
+                        set_tapping_key((keyrecord_t){0});
                         debug_tapping_key();
                         return true;
                     }
 #    endif // defined(FLOW_TAP_TERM)
                     ac_dprintf("Tapping: Start with interfering other tap.\n");
-                    tapping_key = *keyp;
+                    set_tapping_key(*keyp);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -613,16 +667,22 @@ bool process_tapping(keyrecord_t *keyp) {
             ac_dprintf("Tapping: End(Timeout after releasing last tap): ");
             debug_event(event);
             ac_dprintf("\n");
-            tapping_key = (keyrecord_t){0};
+            set_tapping_key((keyrecord_t){0});
             debug_tapping_key();
             return false;
         }
     }
 }
 
+/** \brief Is the key a matrix position covered by the waiting buffer index
+ */
+static inline bool waiting_buffer_indexed(keypos_t key) {
+    return key.row < MATRIX_ROWS && key.col < MATRIX_COLS;
+}
+
 /** \brief Waiting buffer enq
  *
- * FIXME: Needs docs
+ * Appends the record to the waiting buffer, and returns false if it is full.
  */
 bool waiting_buffer_enq(keyrecord_t record) {
     if (IS_NOEVENT(record.event)) {
@@ -637,25 +697,67 @@ bool waiting_buffer_enq(keyrecord_t record) {
     waiting_buffer[waiting_buffer_head] = record;
     waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
 
+    const keypos_t key = record.event.key;
+    if (waiting_buffer_indexed(key)) {
+        matrix_row_t *index = record.event.pressed ? waiting_buffer_presses : waiting_buffer_releases;
+        index[key.row] |= (matrix_row_t)1 << key.col;
+    }
+    if (record.event.pressed) {
+        waiting_buffer_pressed_count++;
+    }
+
     ac_dprintf("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
+/** \brief Waiting buffer pop
+ *
+ * Removes the oldest record from the waiting buffer, once it has been processed.
+ */
+void waiting_buffer_pop(void) {
+    const keyevent_t event = waiting_buffer[waiting_buffer_tail].event;
+    waiting_buffer_tail    = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+
+    if (event.pressed) {
+        waiting_buffer_pressed_count--;
+    }
+    if (!waiting_buffer_indexed(event.key)) {
+        return;
+    }
+    // The key may have been typed more than once while waiting.
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+        if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed == waiting_buffer[i].event.pressed) {
+            return;
+        }
+    }
+    matrix_row_t *index = event.pressed ? waiting_buffer_presses : waiting_buffer_releases;
+    index[event.key.row] &= ~((matrix_row_t)1 << event.key.col);
+}
+
 /** \brief Waiting buffer clear
  *
- * FIXME: Needs docs
+ * Drops every record of the waiting buffer.
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_head          = 0;
+    waiting_buffer_tail          = 0;
+    waiting_buffer_pressed_count = 0;
+    memset(waiting_buffer_presses, 0, sizeof(waiting_buffer_presses));
+    memset(waiting_buffer_releases, 0, sizeof(waiting_buffer_releases));
 }
 
 /** \brief Waiting buffer typed
  *
- * FIXME: Needs docs
+ * Returns whether the waiting buffer holds the opposite event of the same key,
+ * e.g. the press of a key being released.
  */
 bool waiting_buffer_typed(keyevent_t event) {
+    if (waiting_buffer_indexed(event.key)) {
+        const matrix_row_t *index = event.pressed ? waiting_buffer_releases : waiting_buffer_presses;
+        return (index[event.key.row] >> event.key.col) & 1;
+    }
+
     for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
             return true;
@@ -666,13 +768,14 @@ bool waiting_buffer_typed(keyevent_t event) {
 
 /** \brief Waiting buffer has anykey pressed
  *
- * FIXME: Needs docs
+ * Returns whether the waiting buffer holds any key press.
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
-    }
-    return false;
+    return waiting_buffer_pressed_count > 0;
+}
+
+uint16_t get_waiting_buffer_overflows(void) {
+    return waiting_buffer_overflows;
 }
 
 /** \brief Scan buffer for tapping
@@ -687,6 +790,11 @@ void waiting_buffer_scan_tap(void) {
         return;
     }
 
+    // nothing to find if the tapping key was not released yet
+    if (waiting_buffer_indexed(tapping_key.event.key) && !waiting_buffer_typed(tapping_key.event)) {
+        return;
+    }
+
 #    if (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT))
     TAP_DEFINE_KEYCODE;
 #    endif
@@ -797,7 +905,7 @@ static void waiting_buffer_chordal_hold_taps_until(keypos_t key) {
             registered_taps_add(record->event.key);
         }
         process_record(record);
-        waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+        waiting_buffer_pop();
 
         if (KEYEQ(key, record->event.key) && record->event.pressed) {
             break;
@@ -806,7 +914,7 @@ static void waiting_buffer_chordal_hold_taps_until(keypos_t key) {
 }
 
 static void waiting_buffer_process_regular(void) {
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_pop()) {
         if (is_tap_record(&waiting_buffer[waiting_buffer_tail])) {
             break; // Stop once a tap-hold key event is reached.
         }
@@ -326,6 +326,25 @@ void send_keyboard_report(void) {
     send_6kro_report();
 }
 
+/** \brief Get the number of free key slots in the keyboard report
+ *
+ * In 6KRO the keys that are already held are left alone.
+ */
+uint8_t get_keyboard_report_free_keys(void) {
+#ifdef NKRO_ENABLE
+    if (host_can_send_nkro() && keymap_config.nkro) {
+        return UINT8_MAX;
+    }
+#endif
+    uint8_t free = 0;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report->keys[i] == KC_NO) {
+            free++;
+        }
+    }
+    return free;
+}
+
 /** \brief Get mods
  *
  * FIXME: needs doc
@@ -32,6 +32,16 @@ extern report_nkro_t *nkro_report;
 
 void send_keyboard_report(void);
 
+/* Time a keyboard report has to be held for the host to poll it, in ms */
+#ifdef USB_POLLING_INTERVAL_MS
+#    define KEYBOARD_REPORT_POLL_INTERVAL USB_POLLING_INTERVAL_MS
+#else
+#    define KEYBOARD_REPORT_POLL_INTERVAL 1
+#endif
+
+/* Number of keys that can be added to the report without dropping a held one, UINT8_MAX with NKRO */
+uint8_t get_keyboard_report_free_keys(void);
+
 /* key */
 inline void add_key(uint8_t key) {
     add_key_to_report(key);
@@ -5,6 +5,9 @@
 /*
     This API allows for basic profiling information to be printed out over console.
 
+    Superseded by PROFILING_ENABLE (see profiling.h), which keeps min/max/mean and
+    histogram statistics for named sections and can be read over raw HID.
+
     Usage example:
 
         #include "basic_profiling.h"
@@ -0,0 +1,156 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dynamic_combo.h"
+#include "keymap_introspection.h"
+#include "process_combo.h"
+#include "keycodes.h"
+#include "nvm_dynamic_combo.h"
+
+#ifdef __AVR__
+// The combo engine reads combo keys from flash on AVR
+#    error "Dynamic combos are not supported on AVR"
+#endif
+
+// Changes when the slot layout does, so that stale data is reset
+#define DYNAMIC_COMBO_HEADER (0xC000 | DYNAMIC_COMBO_KEYS)
+
+// Filled slots, each one's keys followed by COMBO_END, packed one after the other
+static combo_t  dynamic_combos[DYNAMIC_COMBO_COUNT];
+static uint16_t dynamic_combo_keys[DYNAMIC_COMBO_COUNT * (DYNAMIC_COMBO_KEYS + 1)];
+static uint8_t  dynamic_combo_loaded = 0;
+
+// Changes to the loaded set wait until no combo is in progress, as the combo
+// engine keeps combo indexes and state across key events
+typedef enum { DYNAMIC_COMBO_NONE, DYNAMIC_COMBO_UNLOAD, DYNAMIC_COMBO_LOAD } dynamic_combo_pending_t;
+static dynamic_combo_pending_t dynamic_combo_pending = DYNAMIC_COMBO_NONE;
+
+static inline uint16_t read_keycode(const uint8_t *data) {
+    // Big endian, so we can read/write NVM directly from host if we want
+    return (data[0] << 8) | data[1];
+}
+
+static inline void write_keycode(uint8_t *data, uint16_t keycode) {
+    data[0] = (uint8_t)(keycode >> 8);
+    data[1] = (uint8_t)(keycode & 0xFF);
+}
+
+static void dynamic_combo_unload(void) {
+    dynamic_combo_loaded = 0;
+    combo_keycode_index_invalidate();
+}
+
+static void dynamic_combo_load(void) {
+    uint16_t *keys = dynamic_combo_keys;
+
+    dynamic_combo_loaded = 0;
+    for (uint8_t slot = 0; slot < DYNAMIC_COMBO_COUNT; slot++) {
+        uint8_t data[DYNAMIC_COMBO_SLOT_SIZE];
+        nvm_dynamic_combo_read_buffer(slot * DYNAMIC_COMBO_SLOT_SIZE, sizeof(data), data);
+
+        uint8_t key_count = 0;
+        while (key_count < DYNAMIC_COMBO_KEYS && read_keycode(&data[key_count * 2]) != KC_NO) {
+            keys[key_count] = read_keycode(&data[key_count * 2]);
+            key_count++;
+        }
+
+        const uint16_t keycode = read_keycode(&data[DYNAMIC_COMBO_KEYS * 2]);
+        if (key_count == 0 || keycode == KC_NO) {
+            continue;
+        }
+
+        keys[key_count]                        = COMBO_END;
+        dynamic_combos[dynamic_combo_loaded++] = (combo_t){.keys = keys, .keycode = keycode};
+        keys += key_count + 1;
+    }
+    combo_keycode_index_invalidate();
+}
+
+void dynamic_combo_task(void) {
+    if (dynamic_combo_pending == DYNAMIC_COMBO_NONE || !combo_is_idle()) {
+        return;
+    }
+    if (dynamic_combo_pending == DYNAMIC_COMBO_LOAD) {
+        dynamic_combo_load();
+    } else {
+        dynamic_combo_unload();
+    }
+    dynamic_combo_pending = DYNAMIC_COMBO_NONE;
+}
+
+static void dynamic_combo_request(dynamic_combo_pending_t change) {
+    dynamic_combo_pending = change;
+    dynamic_combo_task();
+}
+
+void dynamic_combo_init(void) {
+    if (nvm_dynamic_combo_read_header() != DYNAMIC_COMBO_HEADER) {
+        dynamic_combo_reset();
+        return;
+    }
+    dynamic_combo_request(DYNAMIC_COMBO_LOAD);
+}
+
+uint8_t dynamic_combo_get_count(void) {
+    return DYNAMIC_COMBO_COUNT;
+}
+
+uint8_t dynamic_combo_get_key_count(void) {
+    return DYNAMIC_COMBO_KEYS;
+}
+
+uint16_t dynamic_combo_get_buffer_size(void) {
+    return (uint16_t)nvm_dynamic_combo_size();
+}
+
+void dynamic_combo_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    nvm_dynamic_combo_read_buffer(offset, size, data);
+}
+
+void dynamic_combo_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    // Don't fire half written combos
+    dynamic_combo_request(DYNAMIC_COMBO_UNLOAD);
+    nvm_dynamic_combo_update_buffer(offset, size, data);
+}
+
+void dynamic_combo_commit(void) {
+    dynamic_combo_request(DYNAMIC_COMBO_LOAD);
+}
+
+bool dynamic_combo_set(uint8_t index, const uint16_t *keys, uint8_t key_count, uint16_t keycode) {
+    if (index >= DYNAMIC_COMBO_COUNT || key_count > DYNAMIC_COMBO_KEYS) {
+        return false;
+    }
+
+    uint8_t data[DYNAMIC_COMBO_SLOT_SIZE] = {0};
+    for (uint8_t i = 0; i < key_count; i++) {
+        write_keycode(&data[i * 2], keys[i]);
+    }
+    write_keycode(&data[DYNAMIC_COMBO_KEYS * 2], key_count ? keycode : KC_NO);
+
+    nvm_dynamic_combo_update_buffer(index * DYNAMIC_COMBO_SLOT_SIZE, sizeof(data), data);
+    dynamic_combo_request(DYNAMIC_COMBO_LOAD);
+    return true;
+}
+
+void dynamic_combo_reset(void) {
+    // Erase the combos, if necessary.
+    nvm_dynamic_combo_erase();
+    nvm_dynamic_combo_reset();
+    nvm_dynamic_combo_update_header(DYNAMIC_COMBO_HEADER);
+    dynamic_combo_request(DYNAMIC_COMBO_LOAD);
+}
+
+// These override the ones in quantum/keymap_introspection.c, the dynamic combos come after the keymap's
+
+uint16_t combo_count(void) {
+    return combo_count_raw() + dynamic_combo_loaded;
+}
+
+combo_t *combo_get(uint16_t combo_idx) {
+    if (combo_idx < combo_count_raw()) {
+        return combo_get_raw(combo_idx);
+    }
+    combo_idx -= combo_count_raw();
+    return combo_idx < dynamic_combo_loaded ? &dynamic_combos[combo_idx] : NULL;
+}
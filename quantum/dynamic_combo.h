@@ -0,0 +1,102 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup dynamic_combo Dynamic Combos
+ *
+ * \brief Combos stored in non-volatile memory, which can be changed without flashing.
+ *
+ * There are `DYNAMIC_COMBO_COUNT` slots of `DYNAMIC_COMBO_KEYS` keycodes
+ * followed by the output keycode, stored as big endian 16-bit values. Unused
+ * keys are `KC_NO`, and a slot without keys or without an output is empty.
+ *
+ * The filled slots are loaded into RAM at boot and appended after the
+ * combos of the keymap, so that combo lookups never read the NVM.
+ * Writes to the buffer disable the dynamic combos until
+ * `dynamic_combo_commit()` loads the new set, so that a host can upload a
+ * full set in as many writes as needed. While a combo is buffered, active
+ * or partly pressed, changes to the loaded set wait for it to finish.
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef DYNAMIC_COMBO_COUNT
+#    define DYNAMIC_COMBO_COUNT 16
+#endif
+
+#ifndef DYNAMIC_COMBO_KEYS
+#    define DYNAMIC_COMBO_KEYS 4
+#endif
+
+#if DYNAMIC_COMBO_COUNT < 1 || DYNAMIC_COMBO_COUNT > 255
+#    error "DYNAMIC_COMBO_COUNT must be between 1 and 255"
+#endif
+
+#if DYNAMIC_COMBO_KEYS < 1 || DYNAMIC_COMBO_KEYS > 32
+#    error "DYNAMIC_COMBO_KEYS must be between 1 and 32"
+#endif
+
+#define DYNAMIC_COMBO_SLOT_SIZE ((DYNAMIC_COMBO_KEYS + 1) * 2)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Load the combos from NVM, resetting them if the stored layout doesn't match
+ */
+void dynamic_combo_init(void);
+
+/** \brief Apply a change to the loaded combos that waited for the combos in progress
+ */
+void dynamic_combo_task(void);
+
+/** \brief Number of combo slots
+ */
+uint8_t dynamic_combo_get_count(void);
+
+/** \brief Number of keys in each combo slot
+ */
+uint8_t dynamic_combo_get_key_count(void);
+
+/** \brief Size in bytes of the combo buffer
+ */
+uint16_t dynamic_combo_get_buffer_size(void);
+
+/** \brief Read raw bytes from the combo buffer
+ */
+void dynamic_combo_get_buffer(uint16_t offset, uint16_t size, uint8_t *data);
+
+/** \brief Write raw bytes to the combo buffer, disabling dynamic combos until the next commit
+ */
+void dynamic_combo_set_buffer(uint16_t offset, uint16_t size, uint8_t *data);
+
+/** \brief Load the combos written to the buffer
+ */
+void dynamic_combo_commit(void);
+
+/** \brief Store a single combo and load it
+ *
+ * \param index the slot to write
+ * \param keys the keys of the combo, up to `DYNAMIC_COMBO_KEYS`
+ * \param key_count the number of keys, `0` empties the slot
+ * \param keycode the keycode sent by the combo
+ * \return false if the slot or key count is out of range
+ */
+bool dynamic_combo_set(uint8_t index, const uint16_t *keys, uint8_t key_count, uint16_t keycode);
+
+/** \brief Empty every slot
+ */
+void dynamic_combo_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** \} */
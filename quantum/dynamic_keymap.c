@@ -18,9 +18,12 @@
 #include "dynamic_keymap.h"
 #include "keymap_introspection.h"
 #include "action.h"
+#include "action_layer.h"
+#include "action_table.h"
 #include "send_string.h"
 #include "keycodes.h"
 #include "nvm_dynamic_keymap.h"
+#include "util.h"
 
 #ifdef ENCODER_ENABLE
 #    include "encoder.h"
@@ -32,6 +35,12 @@
 #    define DYNAMIC_KEYMAP_MACRO_DELAY TAP_CODE_DELAY
 #endif
 
+#ifndef DYNAMIC_KEYMAP_MACRO_READ_AHEAD
+#    define DYNAMIC_KEYMAP_MACRO_READ_AHEAD 32
+#endif
+
+#define DYNAMIC_KEYMAP_MACRO_OFFSET_NONE 0xFFFF
+
 uint8_t dynamic_keymap_get_layer_count(void) {
     return DYNAMIC_KEYMAP_LAYER_COUNT;
 }
@@ -42,6 +51,13 @@ uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column)
 
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
     nvm_dynamic_keymap_update_keycode(layer, row, column, keycode);
+    clear_resolved_layers_cache();
+    action_table_invalidate_key(layer, row, column);
+#ifdef MATRIX_HAS_GHOST
+    if (layer == 0) {
+        keyboard_real_keys_update(row, column, keycode);
+    }
+#endif
 }
 
 #ifdef ENCODER_MAP_ENABLE
@@ -80,6 +96,14 @@ void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
     nvm_dynamic_keymap_update_buffer(offset, size, data);
+    clear_resolved_layers_cache();
+    action_table_invalidate();
+#ifdef MATRIX_HAS_GHOST
+    // Layer 0 comes first in the buffer
+    if (offset < MATRIX_ROWS * MATRIX_COLS * 2) {
+        keyboard_real_keys_rebuild();
+    }
+#endif
 }
 
 uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
@@ -110,14 +134,65 @@ void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *da
     nvm_dynamic_keymap_macro_read_buffer(offset, size, data);
 }
 
-void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    nvm_dynamic_keymap_macro_update_buffer(offset, size, data);
+// Start of each macro in the buffer, so playback does not have to scan
+// through every macro before it. Rebuilt on first use after a write.
+static uint16_t macro_offsets[DYNAMIC_KEYMAP_MACRO_COUNT];
+static bool     macro_offsets_valid = false;
+
+// Block of the buffer last read from NVM, so playback reads it a block
+// at a time instead of one byte per character.
+static uint8_t  macro_read_ahead[DYNAMIC_KEYMAP_MACRO_READ_AHEAD];
+static uint16_t macro_read_ahead_offset = 0;
+static uint16_t macro_read_ahead_length = 0;
+
+static void dynamic_keymap_macro_invalidate(void) {
+    macro_offsets_valid     = false;
+    macro_read_ahead_length = 0;
+}
+
+static void dynamic_keymap_macro_read_block(uint16_t offset) {
+    uint16_t size           = dynamic_keymap_macro_get_buffer_size();
+    macro_read_ahead_offset = offset;
+    macro_read_ahead_length = MIN(DYNAMIC_KEYMAP_MACRO_READ_AHEAD, size - offset);
+    nvm_dynamic_keymap_macro_read_buffer(offset, macro_read_ahead_length, macro_read_ahead);
+}
+
+static uint8_t dynamic_keymap_read_byte(uint16_t offset) {
+    if (offset < macro_read_ahead_offset || offset >= macro_read_ahead_offset + macro_read_ahead_length) {
+        dynamic_keymap_macro_read_block(offset);
+    }
+    return macro_read_ahead[offset - macro_read_ahead_offset];
+}
+
+static void dynamic_keymap_macro_build_index(void) {
+    uint16_t size = dynamic_keymap_macro_get_buffer_size();
+
+    for (uint8_t i = 0; i < DYNAMIC_KEYMAP_MACRO_COUNT; i++) {
+        macro_offsets[i] = DYNAMIC_KEYMAP_MACRO_OFFSET_NONE;
+    }
+    macro_offsets_valid = true;
+
+    // A buffer without a null at the end is being written, so has no macros.
+    if (size == 0 || dynamic_keymap_read_byte(size - 1) != 0) {
+        return;
+    }
+
+    // Each macro starts after the null character ending the previous one.
+    uint16_t offset = 0;
+    for (uint8_t id = 0; id < DYNAMIC_KEYMAP_MACRO_COUNT && offset < size; id++) {
+        macro_offsets[id] = offset;
+        while (dynamic_keymap_read_byte(offset++) != 0) {
+        }
+    }
 }
 
-static uint8_t dynamic_keymap_read_byte(uint32_t offset) {
-    uint8_t d;
-    nvm_dynamic_keymap_macro_read_buffer(offset, 1, &d);
-    return d;
+void dynamic_keymap_macro_init(void) {
+    dynamic_keymap_macro_build_index();
+}
+
+void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    nvm_dynamic_keymap_macro_update_buffer(offset, size, data);
+    dynamic_keymap_macro_invalidate();
 }
 
 typedef struct send_string_nvm_state_t {
@@ -126,7 +201,10 @@ typedef struct send_string_nvm_state_t {
 
 char send_string_get_next_nvm(void *arg) {
     send_string_nvm_state_t *state = (send_string_nvm_state_t *)arg;
-    char                     ret   = dynamic_keymap_read_byte(state->offset);
+    if (state->offset >= dynamic_keymap_macro_get_buffer_size()) {
+        return 0;
+    }
+    char ret = dynamic_keymap_read_byte(state->offset);
     state->offset++;
     return ret;
 }
@@ -135,6 +213,7 @@ void dynamic_keymap_macro_reset(void) {
     // Erase the macros, if necessary.
     nvm_dynamic_keymap_macro_erase();
     nvm_dynamic_keymap_macro_reset();
+    dynamic_keymap_macro_invalidate();
 }
 
 void dynamic_keymap_macro_send(uint8_t id) {
@@ -146,26 +225,29 @@ void dynamic_keymap_macro_send(uint8_t id) {
     // If it's not zero, then we are in the middle
     // of buffer writing, possibly an aborted buffer
     // write. So do nothing.
-    if (dynamic_keymap_read_byte(nvm_dynamic_keymap_macro_size() - 1) != 0) {
+    uint16_t size = dynamic_keymap_macro_get_buffer_size();
+    uint8_t  last;
+    nvm_dynamic_keymap_macro_read_buffer(size - 1, 1, &last);
+    if (last != 0) {
         return;
     }
 
-    // Skip N null characters
-    // p will then point to the Nth macro
-    uint32_t offset = 0;
-    uint32_t end    = nvm_dynamic_keymap_macro_size();
-    while (id > 0) {
-        // If we are past the end of the buffer, then there is
-        // no Nth macro in the buffer.
-        if (offset == end) {
-            return;
-        }
-        if (dynamic_keymap_read_byte(offset) == 0) {
-            --id;
-        }
-        ++offset;
+    // Start from a fresh block, in case NVM was written behind our back.
+    macro_read_ahead_length = 0;
+    if (!macro_offsets_valid) {
+        dynamic_keymap_macro_build_index();
+    }
+
+    // If there is no Nth macro in the buffer, do nothing.
+    uint16_t offset = macro_offsets[id];
+    if (offset == DYNAMIC_KEYMAP_MACRO_OFFSET_NONE) {
+        return;
     }
 
     send_string_nvm_state_t state = {.offset = offset};
+#ifdef SEND_STRING_ASYNC_ENABLE
+    send_string_async_impl(send_string_get_next_nvm, &state, sizeof(state), DYNAMIC_KEYMAP_MACRO_DELAY, NULL, NULL);
+#else
     send_string_with_delay_impl(send_string_get_next_nvm, &state, DYNAMIC_KEYMAP_MACRO_DELAY);
+#endif
 }
@@ -67,11 +67,16 @@ void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data);
 // number of nulls to be in the buffer.
 // Note: dynamic_keymap_macro_get_count() returns the maximum that *can* be
 // stored, not the current count of macros in the buffer.
+//
+// dynamic_keymap_macro_init() indexes where each macro starts, so sending
+// the last one does not scan the whole buffer first. Writing the buffer
+// drops the index, and it is rebuilt on the next send.
 
 uint8_t  dynamic_keymap_macro_get_count(void);
 uint16_t dynamic_keymap_macro_get_buffer_size(void);
 void     dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data);
 void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data);
 void     dynamic_keymap_macro_reset(void);
+void     dynamic_keymap_macro_init(void);
 
 void dynamic_keymap_macro_send(uint8_t id);
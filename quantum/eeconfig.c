@@ -47,6 +47,10 @@ void eeconfig_init_via(void);
 void dynamic_keymap_reset(void);
 #endif // VIA_ENABLE
 
+#ifdef DYNAMIC_COMBO_ENABLE
+#    include "dynamic_combo.h"
+#endif // DYNAMIC_COMBO_ENABLE
+
 #ifndef NKRO_DEFAULT_ON
 #    define NKRO_DEFAULT_ON false
 #endif
@@ -157,6 +161,10 @@ void eeconfig_init_quantum(void) {
     dynamic_keymap_reset();
 #endif
 
+#if defined(DYNAMIC_COMBO_ENABLE) && !defined(VIA_ENABLE)
+    dynamic_combo_reset();
+#endif
+
     eeconfig_init_kb();
 
 #ifdef RGB_MATRIX_ENABLE
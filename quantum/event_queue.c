@@ -0,0 +1,49 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "event_queue.h"
+#include "action.h"
+
+static keyevent_t events[EVENT_QUEUE_SIZE];
+
+// Free running positions, the head is only written by the producer and the
+// tail by the consumer. Their difference is the number of queued events.
+static uint8_t head = 0;
+static uint8_t tail = 0;
+
+bool event_queue_push(keyevent_t event) {
+    const uint8_t pos = head;
+    if ((uint8_t)(pos - __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) >= EVENT_QUEUE_SIZE) {
+        return false;
+    }
+
+    events[pos % EVENT_QUEUE_SIZE] = event;
+    __atomic_store_n(&head, (uint8_t)(pos + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+bool event_queue_pop(keyevent_t *event) {
+    const uint8_t pos = tail;
+    if (pos == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    *event = events[pos % EVENT_QUEUE_SIZE];
+    __atomic_store_n(&tail, (uint8_t)(pos + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+uint8_t event_queue_count(void) {
+    return __atomic_load_n(&head, __ATOMIC_ACQUIRE) - __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+}
+
+bool event_queue_task(void) {
+    keyevent_t event;
+    bool       processed = false;
+
+    while (event_queue_pop(&event)) {
+        action_exec(event);
+        processed = true;
+    }
+    return processed;
+}
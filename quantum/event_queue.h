@@ -0,0 +1,70 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup event_queue Event Queue API
+ *
+ * \brief Queue of key events between matrix scanning and key processing.
+ *
+ * Without the queue, every key event found by a matrix scan is processed
+ * before the scan continues, so a slow handler (`send_string()`, Unicode input,
+ * dynamic macros, ...) delays the scan and the timestamps of the following
+ * events. With `EVENT_QUEUE_ENABLE`, the scan only timestamps and queues its
+ * events, and they are processed in order once the scan is done.
+ *
+ * The queue has a single producer and a single consumer, and needs no locking
+ * between them: the scan may be moved to a timer interrupt or a separate
+ * thread that calls `event_queue_push()`, while `keyboard_task()` keeps
+ * processing. When the queue is full, the matrix scan leaves the remaining
+ * changes for its next pass, so no event is lost.
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+#ifndef EVENT_QUEUE_SIZE
+#    define EVENT_QUEUE_SIZE 16
+#endif
+
+#if EVENT_QUEUE_SIZE < 2 || EVENT_QUEUE_SIZE > 128 || (EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) != 0
+#    error "EVENT_QUEUE_SIZE must be a power of two between 2 and 128"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Queue an event, from the producer side
+ *
+ * \return false if the queue is full
+ */
+bool event_queue_push(keyevent_t event);
+
+/** \brief Take the oldest event, from the consumer side
+ *
+ * \return false if the queue is empty
+ */
+bool event_queue_pop(keyevent_t *event);
+
+/** \brief Number of queued events
+ */
+uint8_t event_queue_count(void);
+
+/** \brief Process every queued event, in order
+ *
+ * \return true if any event was processed
+ */
+bool event_queue_task(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** \} */
@@ -16,6 +16,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "keycode_config.h"
 #include "matrix.h"
@@ -32,6 +33,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "profiling.h"
+#include "task_scheduler.h"
+#include "latency_tracer.h"
+#ifdef EVENT_QUEUE_ENABLE
+#    include "event_queue.h"
+#endif
+#ifdef SEND_STRING_ASYNC_ENABLE
+#    include "send_string.h"
+#endif
 #ifdef BOOTMAGIC_ENABLE
 #    include "bootmagic.h"
 #endif
@@ -71,6 +81,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef COMBO_ENABLE
 #    include "process_combo.h"
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+#    include "dynamic_keymap.h"
+#endif
+#ifdef DYNAMIC_COMBO_ENABLE
+#    include "dynamic_combo.h"
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+#    include "process_dynamic_macro.h"
+#endif
 #ifdef TAP_DANCE_ENABLE
 #    include "process_tap_dance.h"
 #endif
@@ -226,16 +245,39 @@ uint32_t get_matrix_scan_rate(void) {
 #endif
 
 #ifdef MATRIX_HAS_GHOST
-static matrix_row_t get_real_keys(uint8_t row, matrix_row_t rowdata) {
-    matrix_row_t out = 0;
-    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-        // read each key in the row data and check if the keymap defines it as a real key
-        if (keycode_at_keymap_location(0, row, col) && (rowdata & (((matrix_row_t)1) << col))) {
-            // this creates new row data, if a key is defined in the keymap, it will be set here
-            out |= ((matrix_row_t)1) << col;
+// Keys defined on layer 0, so that keymap lookups stay out of the scan path
+static matrix_row_t real_keys[MATRIX_ROWS];
+
+/** \brief Rebuild the real key masks from the layer 0 keymap
+ */
+void keyboard_real_keys_rebuild(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t mask = 0;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (keycode_at_keymap_location(0, row, col)) {
+                mask |= ((matrix_row_t)1) << col;
+            }
         }
+        real_keys[row] = mask;
     }
-    return out;
+}
+
+/** \brief Update the real key mask of a single key, after its layer 0 keycode changed
+ */
+void keyboard_real_keys_update(uint8_t row, uint8_t col, uint16_t keycode) {
+    if (row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+        return;
+    }
+    if (keycode) {
+        real_keys[row] |= ((matrix_row_t)1) << col;
+    } else {
+        real_keys[row] &= ~(((matrix_row_t)1) << col);
+    }
+}
+
+static inline matrix_row_t get_real_keys(uint8_t row, matrix_row_t rowdata) {
+    // if a key is defined in the keymap, it will be set here
+    return rowdata & real_keys[row];
 }
 
 static inline bool popcount_more_than_one(matrix_row_t rowdata) {
@@ -457,6 +499,12 @@ void quantum_init(void) {
 void keyboard_init(void) {
     timer_init();
     sync_timer_init();
+#ifdef PROFILING_ENABLE
+    profiling_init();
+#endif
+#ifdef LATENCY_TRACER_ENABLE
+    latency_tracer_reset();
+#endif
 #ifdef VIA_ENABLE
     via_init();
 #endif
@@ -468,6 +516,18 @@ void keyboard_init(void) {
 #endif
     matrix_init();
     quantum_init();
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_macro_init();
+#endif
+#ifdef DYNAMIC_COMBO_ENABLE
+    dynamic_combo_init();
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_init();
+#endif
+#ifdef MATRIX_HAS_GHOST
+    keyboard_real_keys_rebuild();
+#endif
 #ifdef CONNECTION_ENABLE
     connection_init();
 #endif
@@ -563,6 +623,32 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
 #endif
 }
 
+/** \brief Compare the matrix against its previous state, one row at a time
+ *
+ * Matrix implementations with direct access to their packed rows can provide a faster version.
+ */
+__attribute__((weak)) bool matrix_get_changed_rows(const matrix_row_t previous[], uint32_t changed[]) {
+    bool any_changed = false;
+
+    memset(changed, 0, MATRIX_ROW_BITMAP_WORDS * sizeof(uint32_t));
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (matrix_get_row(row) != previous[row]) {
+            changed[row / 32] |= (uint32_t)1 << (row % 32);
+            any_changed = true;
+        }
+    }
+
+    return any_changed;
+}
+
+static inline uint8_t matrix_row_ctz(matrix_row_t bits) {
+#if MATRIX_COLS <= 16
+    return __builtin_ctz(bits);
+#else
+    return __builtin_ctzl(bits);
+#endif
+}
+
 /**
  * @brief Generates a tick event at a maximum rate of 1KHz that drives the
  * internal QMK state machine.
@@ -577,31 +663,28 @@ static inline void generate_tick_event(void) {
 }
 
 /**
- * @brief This task scans the keyboards matrix and processes any key presses
- * that occur.
+ * @brief Scans the keyboards matrix and generates an event for every key that
+ * changed. With EVENT_QUEUE_ENABLE the events are queued, otherwise they are
+ * processed right away.
  *
  * @return true Matrix did change
  * @return false Matrix didn't change
  */
-static bool matrix_task(void) {
+static bool matrix_scan_task(void) {
     if (!matrix_can_read()) {
-        generate_tick_event();
         return false;
     }
 
     static matrix_row_t matrix_previous[MATRIX_ROWS];
+    uint32_t            changed_rows[MATRIX_ROW_BITMAP_WORDS];
 
     matrix_scan();
-    bool matrix_changed = false;
-    for (uint8_t row = 0; row < MATRIX_ROWS && !matrix_changed; row++) {
-        matrix_changed |= matrix_previous[row] ^ matrix_get_row(row);
-    }
+    const bool matrix_changed = matrix_get_changed_rows(matrix_previous, changed_rows);
 
     matrix_scan_perf_task();
 
     // Short-circuit the complete matrix processing if it is not necessary
     if (!matrix_changed) {
-        generate_tick_event();
         return matrix_changed;
     }
 
@@ -611,30 +694,67 @@ static bool matrix_task(void) {
 
     const bool process_keypress = should_process_keypress();
 
-    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
-        const matrix_row_t current_row = matrix_get_row(row);
-        const matrix_row_t row_changes = current_row ^ matrix_previous[row];
+    for (uint8_t word = 0; word < MATRIX_ROW_BITMAP_WORDS; word++) {
+        // Walk the changed rows, then the changed columns, lowest first
+        for (uint32_t rows = changed_rows[word]; rows; rows &= rows - 1) {
+            const uint8_t      row         = word * 32 + __builtin_ctzl(rows);
+            const matrix_row_t current_row = matrix_get_row(row);
+            matrix_row_t       row_changes = current_row ^ matrix_previous[row];
 
-        if (!row_changes || has_ghost_in_row(row, current_row)) {
-            continue;
-        }
+            if (has_ghost_in_row(row, current_row)) {
+                continue;
+            }
 
-        matrix_row_t col_mask = 1;
-        for (uint8_t col = 0; col < MATRIX_COLS; col++, col_mask <<= 1) {
-            if (row_changes & col_mask) {
-                const bool key_pressed = current_row & col_mask;
+            for (; row_changes; row_changes &= row_changes - 1) {
+                const uint8_t col         = matrix_row_ctz(row_changes);
+                const bool    key_pressed = current_row & (MATRIX_ROW_SHIFTER << col);
 
                 if (process_keypress) {
+#ifdef EVENT_QUEUE_ENABLE
+                    if (!event_queue_push(MAKE_KEYEVENT(row, col, key_pressed))) {
+                        // Leave the rest of the row to the next scan
+                        break;
+                    }
+#else
                     action_exec(MAKE_KEYEVENT(row, col, key_pressed));
+#endif
                 }
 
                 switch_events(row, col, key_pressed);
+                matrix_previous[row] ^= MATRIX_ROW_SHIFTER << col;
             }
         }
+    }
 
-        matrix_previous[row] = current_row;
+    return matrix_changed;
+}
+
+/**
+ * @brief This task scans the keyboards matrix and processes any key presses
+ * that occur.
+ *
+ * @return true Matrix did change
+ * @return false Matrix didn't change
+ */
+static bool matrix_task(void) {
+    bool matrix_changed = matrix_scan_task();
+
+#ifdef EVENT_QUEUE_ENABLE
+    bool hold_events = false;
+#    ifdef SEND_STRING_ASYNC_ENABLE
+    // Keys pressed while a character is being typed wait in the queue, in order
+    hold_events = send_string_async_is_mid_character();
+#    endif
+
+    // Also picks up the events of a scan running outside of the main loop
+    if (!hold_events) {
+        matrix_changed |= event_queue_task();
     }
+#endif
 
+    if (!matrix_changed) {
+        generate_tick_event();
+    }
     return matrix_changed;
 }
 
@@ -660,6 +780,10 @@ void quantum_task(void) {
     key_override_task();
 #endif
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+    send_string_async_task();
+#endif
+
 #ifdef SEQUENCER_ENABLE
     sequencer_task();
 #endif
@@ -672,6 +796,10 @@ void quantum_task(void) {
     combo_task();
 #endif
 
+#ifdef DYNAMIC_COMBO_ENABLE
+    dynamic_combo_task();
+#endif
+
 #ifdef LEADER_ENABLE
     leader_task();
 #endif
@@ -701,35 +829,97 @@ void quantum_task(void) {
 #endif
 }
 
-/** \brief Main task that is repeatedly called as fast as possible. */
+// The lower priority tasks, which the task scheduler may defer to a later pass
+static void lighting_task(void) {
+#if defined(RGBLIGHT_ENABLE)
+    if (task_scheduler_should_run(TASK_SCHEDULER_RGBLIGHT)) {
+        rgblight_task();
+        task_scheduler_done(TASK_SCHEDULER_RGBLIGHT);
+    }
+#endif
+
+#ifdef LED_MATRIX_ENABLE
+    if (task_scheduler_should_run(TASK_SCHEDULER_LED_MATRIX)) {
+        led_matrix_task();
+        task_scheduler_done(TASK_SCHEDULER_LED_MATRIX);
+    }
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    if (task_scheduler_should_run(TASK_SCHEDULER_RGB_MATRIX)) {
+        PROFILING_START(PROFILING_SECTION_RGB_MATRIX_TASK);
+        rgb_matrix_task();
+        PROFILING_STOP(PROFILING_SECTION_RGB_MATRIX_TASK);
+        task_scheduler_done(TASK_SCHEDULER_RGB_MATRIX);
+    }
+#endif
+
+#if defined(BACKLIGHT_ENABLE)
+#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
+    if (task_scheduler_should_run(TASK_SCHEDULER_BACKLIGHT)) {
+        backlight_task();
+        task_scheduler_done(TASK_SCHEDULER_BACKLIGHT);
+    }
+#    endif
+#endif
+}
+
+static void display_task(bool activity_has_occurred) {
+#ifdef OLED_ENABLE
+    if (task_scheduler_should_run(TASK_SCHEDULER_OLED)) {
+        PROFILING_START(PROFILING_SECTION_OLED_TASK);
+        oled_task();
+        PROFILING_STOP(PROFILING_SECTION_OLED_TASK);
+        task_scheduler_done(TASK_SCHEDULER_OLED);
+    }
+#    if OLED_TIMEOUT > 0
+    // Wake up oled if user is using those fabulous keys or spinning those encoders!
+    if (activity_has_occurred) oled_on();
+#    endif
+#endif
+
+#ifdef ST7565_ENABLE
+    if (task_scheduler_should_run(TASK_SCHEDULER_ST7565)) {
+        st7565_task();
+        task_scheduler_done(TASK_SCHEDULER_ST7565);
+    }
+#    if ST7565_TIMEOUT > 0
+    // Wake up display if user is using those fabulous keys or spinning those encoders!
+    if (activity_has_occurred) st7565_on();
+#    endif
+#endif
+}
+
+/** \brief Main task that is repeatedly called as fast as possible.
+ *
+ * With `TASK_SCHEDULER_ENABLE`, input and report producing tasks run first on
+ * every pass, and the remaining tasks are gated on their period and on the
+ * time left in the pass, see task_scheduler.h.
+ */
 void keyboard_task(void) {
+    PROFILING_START(PROFILING_SECTION_KEYBOARD_TASK);
+    task_scheduler_loop_begin();
+
     __attribute__((unused)) bool activity_has_occurred = false;
-    if (matrix_task()) {
+
+    PROFILING_START(PROFILING_SECTION_MATRIX_TASK);
+    const bool matrix_changed = matrix_task();
+    PROFILING_STOP(PROFILING_SECTION_MATRIX_TASK);
+    if (matrix_changed) {
         last_matrix_activity_trigger();
         activity_has_occurred = true;
     }
 
+    PROFILING_START(PROFILING_SECTION_QUANTUM_TASK);
     quantum_task();
+    PROFILING_STOP(PROFILING_SECTION_QUANTUM_TASK);
 
 #if defined(SPLIT_WATCHDOG_ENABLE)
     split_watchdog_task();
 #endif
 
-#if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
-#endif
-
-#ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
-#endif
-#ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
-#endif
-
-#if defined(BACKLIGHT_ENABLE)
-#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
-    backlight_task();
-#    endif
+    // With the task scheduler, the lower priority tasks run last instead, so that they can be deferred
+#ifndef TASK_SCHEDULER_ENABLE
+    lighting_task();
 #endif
 
 #ifdef ENCODER_ENABLE
@@ -740,26 +930,17 @@ void keyboard_task(void) {
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
-    if (pointing_device_task()) {
+    PROFILING_START(PROFILING_SECTION_POINTING_DEVICE_TASK);
+    const bool pointing_device_changed = pointing_device_task();
+    PROFILING_STOP(PROFILING_SECTION_POINTING_DEVICE_TASK);
+    if (pointing_device_changed) {
         last_pointing_device_activity_trigger();
         activity_has_occurred = true;
     }
 #endif
 
-#ifdef OLED_ENABLE
-    oled_task();
-#    if OLED_TIMEOUT > 0
-    // Wake up oled if user is using those fabulous keys or spinning those encoders!
-    if (activity_has_occurred) oled_on();
-#    endif
-#endif
-
-#ifdef ST7565_ENABLE
-    st7565_task();
-#    if ST7565_TIMEOUT > 0
-    // Wake up display if user is using those fabulous keys or spinning those encoders!
-    if (activity_has_occurred) st7565_on();
-#    endif
+#ifndef TASK_SCHEDULER_ENABLE
+    display_task(activity_has_occurred);
 #endif
 
 #ifdef MOUSEKEY_ENABLE
@@ -771,7 +952,7 @@ void keyboard_task(void) {
     ps2_mouse_task();
 #endif
 
-#ifdef MIDI_ENABLE
+#if defined(MIDI_ENABLE) && !defined(TASK_SCHEDULER_ENABLE)
     midi_task();
 #endif
 
@@ -779,7 +960,7 @@ void keyboard_task(void) {
     joystick_task();
 #endif
 
-#ifdef BATTERY_ENABLE
+#if defined(BATTERY_ENABLE) && !defined(TASK_SCHEDULER_ENABLE)
     battery_task();
 #endif
 
@@ -787,13 +968,49 @@ void keyboard_task(void) {
     bluetooth_task();
 #endif
 
-#ifdef HAPTIC_ENABLE
+#if defined(HAPTIC_ENABLE) && !defined(TASK_SCHEDULER_ENABLE)
     haptic_task();
 #endif
 
     led_task();
 
+#ifdef TASK_SCHEDULER_ENABLE
+    // Lower priority tasks, may be deferred to a later pass
+    lighting_task();
+    display_task(activity_has_occurred);
+
+#    ifdef MIDI_ENABLE
+    if (task_scheduler_should_run(TASK_SCHEDULER_MIDI)) {
+        midi_task();
+        task_scheduler_done(TASK_SCHEDULER_MIDI);
+    }
+#    endif
+
+#    ifdef BATTERY_ENABLE
+    if (task_scheduler_should_run(TASK_SCHEDULER_BATTERY)) {
+        battery_task();
+        task_scheduler_done(TASK_SCHEDULER_BATTERY);
+    }
+#    endif
+
+#    ifdef HAPTIC_ENABLE
+    if (task_scheduler_should_run(TASK_SCHEDULER_HAPTIC)) {
+        haptic_task();
+        task_scheduler_done(TASK_SCHEDULER_HAPTIC);
+    }
+#    endif
+#endif
+
 #ifdef OS_DETECTION_ENABLE
-    os_detection_task();
+    if (task_scheduler_should_run(TASK_SCHEDULER_OS_DETECTION)) {
+        os_detection_task();
+        task_scheduler_done(TASK_SCHEDULER_OS_DETECTION);
+    }
+#endif
+
+    PROFILING_STOP(PROFILING_SECTION_KEYBOARD_TASK);
+
+#ifdef PROFILING_ENABLE
+    profiling_task();
 #endif
 }
@@ -40,6 +40,10 @@ typedef struct {
     uint16_t        time;
     keyevent_type_t type;
     bool            pressed;
+#ifdef LATENCY_TRACER_ENABLE
+    bool     stamped; // false for records not built by MAKE_EVENT(), e.g. dynamic macro playback
+    uint32_t timestamp;
+#endif
 } keyevent_t;
 
 /* equivalent test of keypos_t */
@@ -74,7 +78,12 @@ static inline bool IS_DIPSWITCHEVENT(const keyevent_t event) {
 #define MAKE_KEYPOS(row_num, col_num) ((keypos_t){.row = (row_num), .col = (col_num)})
 
 /* Common keyevent_t object factory */
-#define MAKE_EVENT(row_num, col_num, press, event_type) ((keyevent_t){.key = MAKE_KEYPOS((row_num), (col_num)), .pressed = (press), .time = timer_read(), .type = (event_type)})
+#ifdef LATENCY_TRACER_ENABLE
+uint32_t latency_tracer_read_us(void);
+#    define MAKE_EVENT(row_num, col_num, press, event_type) ((keyevent_t){.key = MAKE_KEYPOS((row_num), (col_num)), .pressed = (press), .time = timer_read(), .type = (event_type), .stamped = true, .timestamp = latency_tracer_read_us()})
+#else
+#    define MAKE_EVENT(row_num, col_num, press, event_type) ((keyevent_t){.key = MAKE_KEYPOS((row_num), (col_num)), .pressed = (press), .time = timer_read(), .type = (event_type)})
+#endif
 
 /**
  * @brief Constructs a key event for a pressed or released key.
@@ -114,6 +123,11 @@ bool is_keyboard_master(void);
 /* it runs whenever code has to behave differently on left vs right split */
 bool is_keyboard_left(void);
 
+#ifdef MATRIX_HAS_GHOST
+void keyboard_real_keys_rebuild(void);                                    // To be called when the layer 0 keymap changes
+void keyboard_real_keys_update(uint8_t row, uint8_t col, uint16_t keycode); // To be called when a single layer 0 keycode changes
+#endif
+
 void keyboard_pre_init_kb(void);
 void keyboard_pre_init_user(void);
 void keyboard_post_init_kb(void);
@@ -18,12 +18,7 @@
 
 keymap_config_t keymap_config;
 
-/** \brief keycode_config
- *
- * This function is used to check a specific keycode against the bootmagic config,
- * and will return the corrected keycode, when appropriate.
- */
-__attribute__((weak)) uint16_t keycode_config(uint16_t keycode) {
+static uint16_t translate_keycode(uint16_t keycode) {
     switch (keycode) {
         case KC_CAPS_LOCK:
         case KC_LOCKING_CAPS_LOCK:
@@ -117,13 +112,7 @@ __attribute__((weak)) uint16_t keycode_config(uint16_t keycode) {
     }
 }
 
-/** \brief mod_config
- *
- *  This function checks the mods passed to it against the bootmagic config,
- *  and will remove or replace mods, based on that.
- */
-
-__attribute__((weak)) uint8_t mod_config(uint8_t mod) {
+static uint8_t translate_mods(uint8_t mod) {
     /**
      * Note: This function is for the 5-bit packed mods, NOT the full 8-bit mods.
      * More info about the mods can be seen in modifiers.h.
@@ -163,3 +152,76 @@ __attribute__((weak)) uint8_t mod_config(uint8_t mod) {
 
     return mod;
 }
+
+#ifdef KEYCODE_CONFIG_REMAP_TABLE
+// Every basic keycode that can be remapped is at most KC_CAPS_LOCK, a modifier, or KC_LOCKING_CAPS_LOCK
+#    define REMAP_MODIFIERS (KC_CAPS_LOCK + 1)
+#    define REMAP_LOCKING_CAPS_LOCK (REMAP_MODIFIERS + (KC_RIGHT_GUI - KC_LEFT_CTRL + 1))
+#    define REMAP_MODS_COUNT 32
+
+static uint8_t  basic_remap[REMAP_LOCKING_CAPS_LOCK + 1];
+static uint8_t  mods_remap[REMAP_MODS_COUNT];
+static uint16_t remap_keymap_config;
+static bool     remap_valid = false;
+
+static void remap_rebuild(void) {
+    for (uint8_t keycode = KC_NO; keycode < REMAP_MODIFIERS; keycode++) {
+        basic_remap[keycode] = translate_keycode(keycode);
+    }
+    for (uint8_t keycode = KC_LEFT_CTRL; keycode <= KC_RIGHT_GUI; keycode++) {
+        basic_remap[REMAP_MODIFIERS + (keycode - KC_LEFT_CTRL)] = translate_keycode(keycode);
+    }
+    basic_remap[REMAP_LOCKING_CAPS_LOCK] = translate_keycode(KC_LOCKING_CAPS_LOCK);
+
+    for (uint8_t mod = 0; mod < REMAP_MODS_COUNT; mod++) {
+        mods_remap[mod] = translate_mods(mod);
+    }
+
+    remap_keymap_config = keymap_config.raw;
+    remap_valid         = true;
+}
+
+// keymap_config may be written directly, so follow it rather than rely on every writer to notify
+static inline void remap_update(void) {
+    if (!remap_valid || keymap_config.raw != remap_keymap_config) {
+        remap_rebuild();
+    }
+}
+#endif // KEYCODE_CONFIG_REMAP_TABLE
+
+/** \brief keycode_config
+ *
+ * This function is used to check a specific keycode against the bootmagic config,
+ * and will return the corrected keycode, when appropriate.
+ */
+__attribute__((weak)) uint16_t keycode_config(uint16_t keycode) {
+#ifdef KEYCODE_CONFIG_REMAP_TABLE
+    remap_update();
+    if (keycode < REMAP_MODIFIERS) {
+        return basic_remap[keycode];
+    }
+    if (IS_MODIFIER_KEYCODE(keycode)) {
+        return basic_remap[REMAP_MODIFIERS + (keycode - KC_LEFT_CTRL)];
+    }
+    if (keycode == KC_LOCKING_CAPS_LOCK) {
+        return basic_remap[REMAP_LOCKING_CAPS_LOCK];
+    }
+    return keycode;
+#else
+    return translate_keycode(keycode);
+#endif
+}
+
+/** \brief mod_config
+ *
+ *  This function checks the mods passed to it against the bootmagic config,
+ *  and will remove or replace mods, based on that.
+ */
+__attribute__((weak)) uint8_t mod_config(uint8_t mod) {
+#ifdef KEYCODE_CONFIG_REMAP_TABLE
+    remap_update();
+    return mods_remap[mod & (REMAP_MODS_COUNT - 1)] | (mod & ~(REMAP_MODS_COUNT - 1));
+#else
+    return translate_mods(mod);
+#endif
+}
@@ -25,6 +25,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "keycode_config.h"
 #include "quantum_keycodes.h"
 
+#ifdef ACTION_TABLE_ENABLE
+#    include "action_table.h"
+#endif
+
 #ifdef ENCODER_MAP_ENABLE
 #    include "encoder.h"
 #endif
@@ -47,9 +51,13 @@ extern keymap_config_t keymap_config;
 
 /* converts key to action */
 action_t action_for_key(uint8_t layer, keypos_t key) {
+#ifdef ACTION_TABLE_ENABLE
+    return action_table_action_for_key(layer, key);
+#else
     // 16bit keycodes - important
     uint16_t keycode = keymap_key_to_keycode(layer, key);
     return action_for_keycode(keycode);
+#endif
 };
 
 action_t action_for_keycode(uint16_t keycode) {
@@ -177,6 +177,34 @@ __attribute__((weak)) const key_override_t* key_override_get(uint16_t key_overri
 
 #endif // defined(KEY_OVERRIDE_ENABLE)
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Leader sequences
+
+#if defined(LEADER_ENABLE) && defined(LEADER_SEQUENCE_TABLE)
+
+uint16_t leader_sequences_count_raw(void) {
+    return ARRAY_SIZE(leader_sequences);
+}
+
+__attribute__((weak)) uint16_t leader_sequences_count(void) {
+    return leader_sequences_count_raw();
+}
+
+STATIC_ASSERT(ARRAY_SIZE(leader_sequences) <= LEADER_SEQUENCE_TABLE_SIZE, "Number of leader sequences exceeds LEADER_SEQUENCE_TABLE_SIZE");
+
+const leader_sequence_t* leader_sequences_get_raw(uint16_t leader_sequence_idx) {
+    if (leader_sequence_idx >= leader_sequences_count_raw()) {
+        return NULL;
+    }
+    return &leader_sequences[leader_sequence_idx];
+}
+
+__attribute__((weak)) const leader_sequence_t* leader_sequences_get(uint16_t leader_sequence_idx) {
+    return leader_sequences_get_raw(leader_sequence_idx);
+}
+
+#endif // defined(LEADER_ENABLE) && defined(LEADER_SEQUENCE_TABLE)
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Community modules (must be last in this file!)
 
@@ -0,0 +1,224 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "latency_tracer.h"
+#include "keycodes.h"
+#include "debug.h"
+#include "print.h"
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#    include "chibios_config.h"
+#elif defined(__AVR__)
+#    include <avr/io.h>
+#    include <util/atomic.h>
+#    include "timer_avr.h"
+#endif
+
+static const char *const stage_names[LATENCY_STAGE_COUNT] = {
+    [LATENCY_STAGE_ACTION_EXEC]    = "action_exec",
+    [LATENCY_STAGE_PROCESS_RECORD] = "process_record",
+    [LATENCY_STAGE_REPORT]         = "report",
+};
+
+static const char *const path_names[LATENCY_PATH_COUNT] = {
+    [LATENCY_PATH_PLAIN]     = "plain",
+    [LATENCY_PATH_MOD_TAP]   = "mod_tap",
+    [LATENCY_PATH_COMBO]     = "combo",
+    [LATENCY_PATH_TAP_DANCE] = "tap_dance",
+};
+
+static latency_stats_t stage_stats[LATENCY_STAGE_COUNT];
+static latency_stats_t path_stats[LATENCY_PATH_COUNT];
+
+// Event that the next keyboard report is attributed to
+static struct {
+    uint32_t       timestamp;
+    latency_path_t path;
+    bool           pending;
+} current;
+
+// microsecond timer
+
+#if defined(PROTOCOL_CHIBIOS)
+#    if PORT_SUPPORTS_RT == TRUE
+// The realtime counter is the DWT cycle counter on Cortex-M3 and up
+#        define TRACER_TICKS() ((uint32_t)chSysGetRealtimeCounterX())
+#        define TRACER_TICK_DIFF(start, end) ((uint32_t)((end) - (start)))
+#        define TRACER_TICK_FREQUENCY REALTIME_COUNTER_CLOCK
+#    else
+// Cortex-M0/M0+ have no cycle counter, only the system tick is left
+#        define TRACER_TICKS() ((uint32_t)chVTGetSystemTimeX())
+#        define TRACER_TICK_DIFF(start, end) ((uint32_t)chTimeDiffX((systime_t)(start), (systime_t)(end)))
+#        define TRACER_TICK_FREQUENCY CH_CFG_ST_FREQUENCY
+#    endif
+
+// The counters wrap at their own width and rate, so the elapsed ticks are
+// added up instead of converting the counter itself. This relies on being
+// read at least once per counter wrap, which the tick events of each scan do.
+static uint32_t last_ticks;
+static uint32_t tick_remainder; // in millionths of a tick
+static uint32_t us_count;
+
+uint32_t latency_tracer_read_us(void) {
+    syssts_t sts = chSysGetStatusAndLockX();
+
+    uint32_t ticks  = TRACER_TICKS();
+    uint64_t scaled = (uint64_t)TRACER_TICK_DIFF(last_ticks, ticks) * 1000000 + tick_remainder;
+    last_ticks      = ticks;
+    us_count += (uint32_t)(scaled / TRACER_TICK_FREQUENCY);
+    tick_remainder = (uint32_t)(scaled % TRACER_TICK_FREQUENCY);
+
+    uint32_t us = us_count;
+    chSysRestoreStatusX(sts);
+    return us;
+}
+#elif defined(__AVR__)
+extern volatile uint32_t timer_count;
+
+uint32_t latency_tracer_read_us(void) {
+    uint32_t ms;
+    uint8_t  raw;
+    bool     pending;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms  = timer_count;
+        raw = TIMER_RAW;
+#    if defined(__AVR_ATmega32A__)
+        pending = TIFR & _BV(OCF0);
+#    elif defined(__AVR_ATtiny85__)
+        pending = TIFR & _BV(OCF0A);
+#    else
+        pending = TIFR0 & _BV(OCF0A);
+#    endif
+    }
+
+    // Timer0 wrapped but its interrupt hasn't run yet
+    if (pending && raw < (TIMER_RAW_TOP / 2)) {
+        ms++;
+    }
+
+    return ms * 1000 + ((uint32_t)raw * 1000) / (TIMER_RAW_TOP + 1);
+}
+#else
+// Follow the simulated timer, so that tests can assert exact latencies
+uint32_t latency_tracer_read_us(void) {
+    return timer_read32() * 1000;
+}
+#endif
+
+// statistics
+
+static void reset_stats(latency_stats_t *s) {
+    memset(s, 0, sizeof(latency_stats_t));
+    s->min = UINT32_MAX;
+}
+
+static void record(latency_stats_t *s, uint32_t latency) {
+    if (s->count == UINT32_MAX) {
+        return;
+    }
+
+    s->count++;
+    s->total += latency;
+    if (latency < s->min) s->min = latency;
+    if (latency > s->max) s->max = latency;
+
+    uint8_t bucket = 0;
+    while (bucket < (LATENCY_TRACER_HISTOGRAM_BUCKETS - 1) && latency) {
+        latency >>= 1;
+        bucket++;
+    }
+    if (s->histogram[bucket] < UINT16_MAX) {
+        s->histogram[bucket]++;
+    }
+}
+
+static latency_path_t get_path(keyevent_t event, uint16_t keycode) {
+    if (IS_COMBOEVENT(event)) {
+        return LATENCY_PATH_COMBO;
+    }
+    if (IS_QK_TAP_DANCE(keycode)) {
+        return LATENCY_PATH_TAP_DANCE;
+    }
+    if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        return LATENCY_PATH_MOD_TAP;
+    }
+    return LATENCY_PATH_PLAIN;
+}
+
+void latency_tracer_action_exec(keyevent_t event) {
+    // Records built elsewhere than MAKE_EVENT(), such as dynamic macro playback, aren't stamped
+    if (!IS_KEYEVENT(event) || !event.stamped) {
+        return;
+    }
+    record(&stage_stats[LATENCY_STAGE_ACTION_EXEC], latency_tracer_read_us() - event.timestamp);
+}
+
+void latency_tracer_process_record(keyevent_t event, uint16_t keycode) {
+    if (!IS_KEYEVENT(event) && !IS_COMBOEVENT(event)) {
+        return;
+    }
+    if (!event.stamped) {
+        // Don't attribute the report it causes to an earlier event
+        current.pending = false;
+        return;
+    }
+    record(&stage_stats[LATENCY_STAGE_PROCESS_RECORD], latency_tracer_read_us() - event.timestamp);
+
+    current.timestamp = event.timestamp;
+    current.path      = get_path(event, keycode);
+    current.pending   = true;
+}
+
+void latency_tracer_report_queued(void) {
+    if (!current.pending) {
+        return;
+    }
+    current.pending = false;
+
+    const uint32_t latency = latency_tracer_read_us() - current.timestamp;
+    record(&stage_stats[LATENCY_STAGE_REPORT], latency);
+    record(&path_stats[current.path], latency);
+}
+
+const latency_stats_t *latency_tracer_get_stage_stats(latency_stage_t stage) {
+    return stage < LATENCY_STAGE_COUNT ? &stage_stats[stage] : NULL;
+}
+
+const latency_stats_t *latency_tracer_get_path_stats(latency_path_t path) {
+    return path < LATENCY_PATH_COUNT ? &path_stats[path] : NULL;
+}
+
+uint32_t latency_tracer_get_mean(const latency_stats_t *stats) {
+    if (!stats || stats->count == 0) {
+        return 0;
+    }
+    return (uint32_t)(stats->total / stats->count);
+}
+
+void latency_tracer_reset(void) {
+    for (uint8_t i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        reset_stats(&stage_stats[i]);
+    }
+    for (uint8_t i = 0; i < LATENCY_PATH_COUNT; i++) {
+        reset_stats(&path_stats[i]);
+    }
+    current.pending = false;
+}
+
+// console
+
+static void print_stats(const char *name, const latency_stats_t *s) {
+    dprintf("latency:%s count=%lu min=%lu max=%lu mean=%lu\n", name, (unsigned long)s->count, (unsigned long)(s->count ? s->min : 0), (unsigned long)s->max, (unsigned long)latency_tracer_get_mean(s));
+}
+
+void latency_tracer_print(void) {
+    for (uint8_t i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        print_stats(stage_names[i], &stage_stats[i]);
+    }
+    for (uint8_t i = 0; i < LATENCY_PATH_COUNT; i++) {
+        print_stats(path_names[i], &path_stats[i]);
+    }
+}
@@ -0,0 +1,115 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup latency_tracer Latency Tracer API
+ *
+ * \brief End to end latency of key events, from matrix scan to HID report.
+ *
+ * Every key event is stamped with a microsecond timestamp when it is
+ * generated. The time elapsed since that stamp is recorded when the event
+ * reaches `action_exec()`, each time it enters `process_record_quantum()`, and
+ * when the first keyboard report it causes is handed to the host driver.
+ * Report latencies are also recorded per feature path, so the cost of the
+ * tapping, combo and tap dance buffers can be told apart.
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+#ifndef LATENCY_TRACER_HISTOGRAM_BUCKETS
+#    define LATENCY_TRACER_HISTOGRAM_BUCKETS 20
+#endif
+
+/** \brief Points of the pipeline at which latency is recorded
+ */
+typedef enum {
+    LATENCY_STAGE_ACTION_EXEC,
+    LATENCY_STAGE_PROCESS_RECORD,
+    LATENCY_STAGE_REPORT,
+    LATENCY_STAGE_COUNT,
+} latency_stage_t;
+
+/** \brief Feature paths that report latencies are grouped by
+ */
+typedef enum {
+    LATENCY_PATH_PLAIN,
+    LATENCY_PATH_MOD_TAP,
+    LATENCY_PATH_COMBO,
+    LATENCY_PATH_TAP_DANCE,
+    LATENCY_PATH_COUNT,
+} latency_path_t;
+
+/** \brief Latency statistics, in microseconds
+ *
+ * Bucket 0 counts latencies below 1us, bucket n latencies in [2^(n-1), 2^n),
+ * and the last bucket everything above.
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint16_t histogram[LATENCY_TRACER_HISTOGRAM_BUCKETS];
+} latency_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Read the free running microsecond timer used to stamp key events
+ */
+uint32_t latency_tracer_read_us(void);
+
+/** \brief Record the latency of an event reaching `action_exec()`
+ */
+void latency_tracer_action_exec(keyevent_t event);
+
+/** \brief Record the latency of an event entering `process_record_quantum()`
+ *
+ * The event becomes the one that the next keyboard report is attributed to.
+ */
+void latency_tracer_process_record(keyevent_t event, uint16_t keycode);
+
+/** \brief Record the latency of a keyboard report being handed to the host driver
+ */
+void latency_tracer_report_queued(void);
+
+/** \brief Access the statistics of a stage
+ */
+const latency_stats_t *latency_tracer_get_stage_stats(latency_stage_t stage);
+
+/** \brief Access the report latency statistics of a feature path
+ */
+const latency_stats_t *latency_tracer_get_path_stats(latency_path_t path);
+
+/** \brief Mean latency, in microseconds
+ */
+uint32_t latency_tracer_get_mean(const latency_stats_t *stats);
+
+/** \brief Clear all statistics
+ */
+void latency_tracer_reset(void);
+
+/** \brief Dump every stage and path over the console
+ */
+void latency_tracer_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifndef LATENCY_TRACER_ENABLE
+#    define latency_tracer_action_exec(event)
+#    define latency_tracer_process_record(event, keycode)
+#    define latency_tracer_report_queued()
+#endif
+
+/** \} */
@@ -5,6 +5,12 @@
 #include "timer.h"
 #include "util.h"
 
+#ifdef LEADER_SEQUENCE_TABLE
+#    include "debug.h"
+#    include "keymap_introspection.h"
+#    include "quantum.h"
+#endif
+
 #include <string.h>
 
 #ifndef LEADER_TIMEOUT
@@ -12,10 +18,10 @@
 #endif
 
 // Leader key stuff
-bool     leading              = false;
-uint16_t leader_time          = 0;
-uint16_t leader_sequence[5]   = {0, 0, 0, 0, 0};
-uint8_t  leader_sequence_size = 0;
+bool     leading                                 = false;
+uint16_t leader_time                             = 0;
+uint16_t leader_sequence[LEADER_SEQUENCE_LENGTH] = {0};
+uint8_t  leader_sequence_size                    = 0;
 
 __attribute__((weak)) void leader_start_user(void) {}
 
@@ -25,6 +31,112 @@ __attribute__((weak)) bool leader_add_user(uint16_t keycode) {
     return false;
 }
 
+#ifdef LEADER_SEQUENCE_TABLE
+__attribute__((weak)) void leader_sequence_matched_user(uint16_t index) {}
+
+// The table, sorted by keys, acts as a trie: the sequences starting with the
+// keys typed so far are the range [table_low, table_high) of the sorted order.
+static uint8_t  table_order[LEADER_SEQUENCE_TABLE_SIZE];
+static uint8_t  table_size  = 0;
+static uint16_t table_count = UINT16_MAX;
+static uint8_t  table_low   = 0;
+static uint8_t  table_high  = 0;
+
+static inline uint16_t table_key(uint8_t position, uint8_t depth) {
+    const uint16_t *keys = pgm_read_ptr(&leader_sequences_get(table_order[position])->keys);
+    return pgm_read_word(&keys[depth]);
+}
+
+static bool table_less(uint8_t a, uint8_t b) {
+    const uint16_t *keys_a = pgm_read_ptr(&leader_sequences_get(a)->keys);
+    const uint16_t *keys_b = pgm_read_ptr(&leader_sequences_get(b)->keys);
+    for (uint8_t i = 0;; i++) {
+        uint16_t key_a = pgm_read_word(&keys_a[i]);
+        uint16_t key_b = pgm_read_word(&keys_b[i]);
+        if (key_a != key_b) {
+            return key_a < key_b;
+        }
+        if (key_a == LEADER_SEQUENCE_END) {
+            return false;
+        }
+    }
+}
+
+static void table_build(void) {
+    table_count = leader_sequences_count();
+    table_size  = 0;
+    if (table_count > LEADER_SEQUENCE_TABLE_SIZE) {
+        dprintf("leader: only the first %u sequences fit LEADER_SEQUENCE_TABLE_SIZE\n", LEADER_SEQUENCE_TABLE_SIZE);
+    }
+
+    // Insertion sort, this only runs once
+    for (uint16_t index = 0; index < table_count && index < LEADER_SEQUENCE_TABLE_SIZE; index++) {
+        uint8_t i = table_size++;
+        for (; i > 0 && table_less(index, table_order[i - 1]); i--) {
+            table_order[i] = table_order[i - 1];
+        }
+        table_order[i] = index;
+    }
+}
+
+static void table_start(void) {
+    if (table_count != leader_sequences_count()) {
+        table_build();
+    }
+    table_low  = 0;
+    table_high = table_size;
+}
+
+// Narrows the range to the sequences continuing with the keycode at the given depth
+static void table_advance(uint16_t keycode, uint8_t depth) {
+    if (keycode == LEADER_SEQUENCE_END) {
+        table_high = table_low;
+        return;
+    }
+
+    uint8_t low = table_low, high = table_high;
+    while (low < high) {
+        uint8_t mid = low + (high - low) / 2;
+        if (table_key(mid, depth) < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    table_low = low;
+
+    high = table_high;
+    while (low < high) {
+        uint8_t mid = low + (high - low) / 2;
+        if (table_key(mid, depth) <= keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    table_high = low;
+}
+
+// A sequence ending at the given depth sorts first in the range
+static bool table_matched(uint8_t depth) {
+    return table_low < table_high && table_key(table_low, depth) == LEADER_SEQUENCE_END;
+}
+
+static void table_end(void) {
+    if (!table_matched(leader_sequence_size)) {
+        return;
+    }
+
+    const uint16_t index   = table_order[table_low];
+    const uint16_t keycode = pgm_read_word(&leader_sequences_get(index)->keycode);
+    table_high             = table_low;
+    if (keycode != KC_NO) {
+        tap_code16(keycode);
+    }
+    leader_sequence_matched_user(index);
+}
+#endif
+
 void leader_start(void) {
     if (leading) {
         return;
@@ -34,10 +146,16 @@ void leader_start(void) {
     leader_time          = timer_read();
     leader_sequence_size = 0;
     memset(leader_sequence, 0, sizeof(leader_sequence));
+#ifdef LEADER_SEQUENCE_TABLE
+    table_start();
+#endif
 }
 
 void leader_end(void) {
     leading = false;
+#ifdef LEADER_SEQUENCE_TABLE
+    table_end();
+#endif
     leader_end_user();
 }
 
@@ -65,7 +183,15 @@ bool leader_sequence_add(uint16_t keycode) {
     leader_sequence[leader_sequence_size] = keycode;
     leader_sequence_size++;
 
-    if (leader_add_user(keycode)) {
+    bool finished = leader_add_user(keycode);
+
+#ifdef LEADER_SEQUENCE_TABLE
+    table_advance(keycode, leader_sequence_size - 1);
+    // Finish as soon as no other sequence can follow, rather than waiting for the timeout
+    finished |= table_low == table_high || (table_high - table_low == 1 && table_matched(leader_sequence_size));
+#endif
+
+    if (finished) {
         leader_end();
     }
     return true;
@@ -84,7 +210,7 @@ void leader_reset_timer(void) {
 }
 
 bool leader_sequence_is(uint16_t kc1, uint16_t kc2, uint16_t kc3, uint16_t kc4, uint16_t kc5) {
-    return leader_sequence[0] == kc1 && leader_sequence[1] == kc2 && leader_sequence[2] == kc3 && leader_sequence[3] == kc4 && leader_sequence[4] == kc5;
+    return leader_sequence[0] == kc1 && leader_sequence[1] == kc2 && leader_sequence[2] == kc3 && leader_sequence[3] == kc4 && leader_sequence[4] == kc5 && leader_sequence_size <= 5;
 }
 
 bool leader_sequence_one_key(uint16_t kc) {
@@ -1,6 +1,8 @@
 // Copyright 2023 QMK
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#pragma once
+
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -11,6 +13,37 @@
  * \{
  */
 
+#ifndef LEADER_SEQUENCE_LENGTH
+#    define LEADER_SEQUENCE_LENGTH 5
+#endif
+
+#if LEADER_SEQUENCE_LENGTH < 5 || LEADER_SEQUENCE_LENGTH > 255
+#    error "LEADER_SEQUENCE_LENGTH must be between 5 and 255"
+#endif
+
+#ifndef LEADER_SEQUENCE_TABLE_SIZE
+#    define LEADER_SEQUENCE_TABLE_SIZE 64
+#endif
+
+#if LEADER_SEQUENCE_TABLE_SIZE > 255
+#    error "LEADER_SEQUENCE_TABLE_SIZE must be at most 255"
+#endif
+
+#define LEADER_SEQUENCE_END 0
+
+/**
+ * \brief A leader sequence of the `leader_sequences[]` table.
+ */
+typedef struct leader_sequence_t {
+    const uint16_t *keys;    // keycodes, ending with `LEADER_SEQUENCE_END`
+    uint16_t        keycode; // tapped when the sequence is typed, or `KC_NO`
+} leader_sequence_t;
+
+#define LEADER_SEQUENCE(ck, kc) \
+    { .keys = &(ck)[0], .keycode = (kc) }
+#define LEADER_SEQUENCE_ACTION(ck) \
+    { .keys = &(ck)[0] }
+
 /**
  * \brief User callback, invoked when the leader sequence begins.
  */
@@ -30,6 +63,13 @@ void leader_end_user(void);
  */
 bool leader_add_user(uint16_t keycode);
 
+/**
+ * \brief User callback, invoked when a sequence of the `leader_sequences[]` table is typed.
+ *
+ * \param index The index of the sequence in the table.
+ */
+void leader_sequence_matched_user(uint16_t index);
+
 /**
  * Begin the leader sequence, resetting the buffer and timer.
  */
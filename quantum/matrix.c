@@ -22,6 +22,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "debounce.h"
 #include "atomic_util.h"
 
+#ifdef MATRIX_INTERRUPT_ENABLE
+#    include "matrix_interrupt.h"
+#endif
+
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -266,6 +270,132 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
 #    error DIODE_DIRECTION is not defined!
 #endif
 
+#ifdef MATRIX_INTERRUPT_ENABLE
+#    if defined(PROTOCOL_CHIBIOS)
+#        if !defined(PAL_USE_CALLBACKS) || (PAL_USE_CALLBACKS != TRUE)
+#            error "MATRIX_INTERRUPT_ENABLE requires PAL_USE_CALLBACKS to be TRUE in halconf.h"
+#        endif
+
+#        if defined(MCU_STM32) || defined(MCU_GD32V) || defined(MCU_AT32) || defined(MCU_WB32)
+// Pins with the same pad number on different ports share one EXTI line, so
+// only the first of them is armed, and the others are left to polling
+#            define MATRIX_INTERRUPT_LINE_PER_PAD
+static uint32_t armed_pads = 0;
+#        endif
+
+static void matrix_interrupt_callback(void *arg) {
+    matrix_interrupt_signal();
+}
+
+static inline void matrix_interrupt_enable_pin(pin_t pin) {
+#        ifdef MATRIX_INTERRUPT_LINE_PER_PAD
+    if (armed_pads & (1UL << PAL_PAD(pin))) {
+        return;
+    }
+    armed_pads |= 1UL << PAL_PAD(pin);
+#        endif
+    palEnableLineEvent(pin, PAL_EVENT_MODE_BOTH_EDGES);
+    palSetLineCallback(pin, matrix_interrupt_callback, NULL);
+}
+
+// Pins are disarmed in the order they were armed, so the first pin on a pad is the one holding its line
+static inline void matrix_interrupt_disable_pin(pin_t pin) {
+#        ifdef MATRIX_INTERRUPT_LINE_PER_PAD
+    if (!(armed_pads & (1UL << PAL_PAD(pin)))) {
+        return;
+    }
+    armed_pads &= ~(1UL << PAL_PAD(pin));
+#        endif
+    palDisableLineEvent(pin);
+}
+#    else
+// No generic pin change support, matrix_interrupt_read_pins() is polled instead
+static inline void matrix_interrupt_enable_pin(pin_t pin) {}
+static inline void matrix_interrupt_disable_pin(pin_t pin) {}
+#    endif
+
+#    if defined(DIRECT_PINS)
+
+void matrix_interrupt_arm_pins(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (direct_pins[row][col] != NO_PIN) {
+                matrix_interrupt_enable_pin(direct_pins[row][col]);
+            }
+        }
+    }
+}
+
+void matrix_interrupt_disarm_pins(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (direct_pins[row][col] != NO_PIN) {
+                matrix_interrupt_disable_pin(direct_pins[row][col]);
+            }
+        }
+    }
+}
+
+bool matrix_interrupt_read_pins(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (readMatrixPin(direct_pins[row][col]) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+#    elif defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS)
+#        if (DIODE_DIRECTION == COL2ROW)
+#            define MATRIX_INTERRUPT_OUTPUTS MATRIX_ROWS_PER_HAND
+#            define MATRIX_INTERRUPT_INPUTS MATRIX_COLS
+#            define matrix_interrupt_select(x) select_row(x)
+#            define matrix_interrupt_unselect_all() unselect_rows()
+#            define matrix_interrupt_input_pin(x) col_pins[x]
+#        elif (DIODE_DIRECTION == ROW2COL)
+#            define MATRIX_INTERRUPT_OUTPUTS MATRIX_COLS
+#            define MATRIX_INTERRUPT_INPUTS MATRIX_ROWS_PER_HAND
+#            define matrix_interrupt_select(x) select_col(x)
+#            define matrix_interrupt_unselect_all() unselect_cols()
+#            define matrix_interrupt_input_pin(x) row_pins[x]
+#        endif
+
+void matrix_interrupt_arm_pins(void) {
+    // Drive every output so that any pressed key pulls its input
+    for (uint8_t x = 0; x < MATRIX_INTERRUPT_OUTPUTS; x++) {
+        matrix_interrupt_select(x);
+    }
+    for (uint8_t x = 0; x < MATRIX_INTERRUPT_INPUTS; x++) {
+        if (matrix_interrupt_input_pin(x) != NO_PIN) {
+            matrix_interrupt_enable_pin(matrix_interrupt_input_pin(x));
+        }
+    }
+}
+
+void matrix_interrupt_disarm_pins(void) {
+    for (uint8_t x = 0; x < MATRIX_INTERRUPT_INPUTS; x++) {
+        if (matrix_interrupt_input_pin(x) != NO_PIN) {
+            matrix_interrupt_disable_pin(matrix_interrupt_input_pin(x));
+        }
+    }
+    matrix_interrupt_unselect_all();
+    matrix_output_unselect_delay(0, true);
+}
+
+bool matrix_interrupt_read_pins(void) {
+    for (uint8_t x = 0; x < MATRIX_INTERRUPT_INPUTS; x++) {
+        if (readMatrixPin(matrix_interrupt_input_pin(x)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#    endif
+#endif // MATRIX_INTERRUPT_ENABLE
+
 void matrix_init(void) {
 #ifdef SPLIT_KEYBOARD
     // Set pinout for right half if pinout for that half is defined
@@ -316,20 +446,46 @@ __attribute__((weak)) bool transport_master_if_connected(matrix_row_t master_mat
 }
 #endif
 
-uint8_t matrix_scan(void) {
-    matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
-
+static inline void matrix_read(matrix_row_t current_matrix[]) {
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < MATRIX_ROWS_PER_HAND; current_row++) {
-        matrix_read_cols_on_row(curr_matrix, current_row);
+        matrix_read_cols_on_row(current_matrix, current_row);
     }
 #elif (DIODE_DIRECTION == ROW2COL)
     // Set col, read rows
     matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
     for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++, row_shifter <<= 1) {
-        matrix_read_rows_on_col(curr_matrix, current_col, row_shifter);
+        matrix_read_rows_on_col(current_matrix, current_col, row_shifter);
+    }
+#endif
+}
+
+#ifdef MATRIX_INTERRUPT_ENABLE
+static bool matrix_keys_active(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS_PER_HAND; row++) {
+#    ifdef SPLIT_KEYBOARD
+        if (raw_matrix[row] | matrix[thisHand + row]) return true;
+#    else
+        if (raw_matrix[row] | matrix[row]) return true;
+#    endif
+    }
+    return false;
+}
+#endif
+
+uint8_t matrix_scan(void) {
+    matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
+
+#ifdef MATRIX_INTERRUPT_ENABLE
+    // While parked the pins are configured for wake detection, so leave the raw state untouched
+    if (matrix_interrupt_should_scan()) {
+        matrix_read(curr_matrix);
+    } else {
+        memcpy(curr_matrix, raw_matrix, sizeof(curr_matrix));
     }
+#else
+    matrix_read(curr_matrix);
 #endif
 
     bool changed = memcmp(raw_matrix, curr_matrix, sizeof(curr_matrix)) != 0;
@@ -341,5 +497,9 @@ uint8_t matrix_scan(void) {
     changed = debounce(raw_matrix, matrix, MATRIX_ROWS_PER_HAND, changed);
     matrix_scan_kb();
 #endif
+
+#ifdef MATRIX_INTERRUPT_ENABLE
+    matrix_interrupt_scan_done(changed || matrix_keys_active());
+#endif
     return (uint8_t)changed;
 }
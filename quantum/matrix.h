@@ -43,6 +43,9 @@ typedef uint32_t matrix_row_t;
 
 #define MATRIX_ROW_SHIFTER ((matrix_row_t)1)
 
+/* number of 32-bit words in a bitmap with one bit per row */
+#define MATRIX_ROW_BITMAP_WORDS ((MATRIX_ROWS + 31) / 32)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -63,6 +66,8 @@ bool matrix_can_read(void);
 bool matrix_is_on(uint8_t row, uint8_t col);
 /* matrix state on row */
 matrix_row_t matrix_get_row(uint8_t row);
+/* compare matrix state against previous, set one bit per changed row in changed, return whether any row changed */
+bool matrix_get_changed_rows(const matrix_row_t previous[], uint32_t changed[]);
 /* print matrix for debug */
 void matrix_print(void);
 /* delay between changing matrix pin state and reading values */
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "matrix.h"
 #include "debounce.h"
 #include "wait.h"
@@ -7,7 +8,6 @@
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
-#    include <string.h>
 #endif
 
 #ifndef MATRIX_IO_DELAY
@@ -76,6 +76,42 @@ inline matrix_row_t matrix_get_row(uint8_t row) {
 #    define print_matrix_row(row) print_bin_reverse32(matrix_get_row(row))
 #endif
 
+#ifndef MATRIX_MASKED
+/* Rows are packed, so a block of unchanged rows is skipped with a single 32-bit compare */
+#    define ROWS_PER_WORD (sizeof(uint32_t) / sizeof(matrix_row_t))
+
+bool matrix_get_changed_rows(const matrix_row_t previous[], uint32_t changed[]) {
+    bool    any_changed = false;
+    uint8_t row         = 0;
+
+    memset(changed, 0, MATRIX_ROW_BITMAP_WORDS * sizeof(uint32_t));
+
+    for (; row + ROWS_PER_WORD <= MATRIX_ROWS; row += ROWS_PER_WORD) {
+        uint32_t current_word, previous_word;
+        memcpy(&current_word, &matrix[row], sizeof(uint32_t));
+        memcpy(&previous_word, &previous[row], sizeof(uint32_t));
+        if (current_word == previous_word) {
+            continue;
+        }
+        for (uint8_t i = row; i < row + ROWS_PER_WORD; i++) {
+            if (matrix[i] != previous[i]) {
+                changed[i / 32] |= (uint32_t)1 << (i % 32);
+                any_changed = true;
+            }
+        }
+    }
+
+    for (; row < MATRIX_ROWS; row++) {
+        if (matrix[row] != previous[row]) {
+            changed[row / 32] |= (uint32_t)1 << (row % 32);
+            any_changed = true;
+        }
+    }
+
+    return any_changed;
+}
+#endif
+
 void matrix_print(void) {
     print_matrix_header();
 
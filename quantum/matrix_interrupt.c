@@ -0,0 +1,111 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "matrix_interrupt.h"
+#include "timer.h"
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#    include <hal.h>
+#endif
+
+#ifndef MATRIX_INTERRUPT_WAIT_TIMEOUT
+#    define MATRIX_INTERRUPT_WAIT_TIMEOUT 1
+#endif
+
+static volatile bool wake_pending  = false;
+static bool          armed         = false;
+static uint32_t      last_activity = 0;
+static uint32_t      last_wake     = 0;
+static uint32_t      wake_count    = 0;
+
+#if defined(PROTOCOL_CHIBIOS)
+static thread_reference_t waiting_thread = NULL;
+
+void matrix_interrupt_signal(void) {
+    osalSysLockFromISR();
+    wake_pending = true;
+    osalThreadResumeI(&waiting_thread, MSG_OK);
+    osalSysUnlockFromISR();
+}
+#else
+void matrix_interrupt_signal(void) {
+    wake_pending = true;
+}
+#endif
+
+bool matrix_interrupt_should_scan(void) {
+    if (!armed) {
+        return true;
+    }
+
+    // Catch edges that raced with arming, or poll on platforms without interrupts
+    if (!wake_pending && !matrix_interrupt_read_pins()) {
+        matrix_interrupt_wait();
+        if (!wake_pending) {
+            return false;
+        }
+    }
+
+    wake_pending = false;
+    armed        = false;
+    matrix_interrupt_disarm_pins();
+
+    last_wake = last_activity = timer_read32();
+    wake_count++;
+    return true;
+}
+
+void matrix_interrupt_scan_done(bool active) {
+    if (armed) {
+        return;
+    }
+
+    if (active) {
+        last_activity = timer_read32();
+        return;
+    }
+
+    if (timer_elapsed32(last_activity) >= MATRIX_INTERRUPT_IDLE_TIMEOUT) {
+        wake_pending = false;
+        armed        = true;
+        matrix_interrupt_arm_pins();
+    }
+}
+
+bool matrix_interrupt_is_armed(void) {
+    return armed;
+}
+
+uint32_t matrix_interrupt_last_wake(void) {
+    return last_wake;
+}
+
+uint32_t matrix_interrupt_wake_count(void) {
+    return wake_count;
+}
+
+// matrix driver hooks
+
+__attribute__((weak)) void matrix_interrupt_arm_pins(void) {}
+
+__attribute__((weak)) void matrix_interrupt_disarm_pins(void) {}
+
+__attribute__((weak)) bool matrix_interrupt_read_pins(void) {
+    return false;
+}
+
+// platform hooks
+
+#if defined(PROTOCOL_CHIBIOS)
+__attribute__((weak)) void matrix_interrupt_wait(void) {
+    // Bounded so that the rest of the main loop still runs while parked
+    osalSysLock();
+    if (!wake_pending) {
+        osalThreadSuspendTimeoutS(&waiting_thread, TIME_MS2I(MATRIX_INTERRUPT_WAIT_TIMEOUT));
+    }
+    osalSysUnlock();
+}
+#else
+__attribute__((weak)) void matrix_interrupt_wait(void) {}
+#endif
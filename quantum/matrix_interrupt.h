@@ -0,0 +1,90 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup matrix_interrupt Interrupt driven matrix scanning
+ *
+ * \brief Parks the matrix while no keys are held and only resumes scanning
+ * once a pin change has been signalled.
+ *
+ * While keys are active the matrix is scanned on every pass of the main loop.
+ * After `MATRIX_INTERRUPT_IDLE_TIMEOUT` milliseconds without any activity the
+ * matrix driver drives all of its outputs, enables edge interrupts on its
+ * inputs and the scan is skipped until `matrix_interrupt_signal()` is called.
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef MATRIX_INTERRUPT_IDLE_TIMEOUT
+#    define MATRIX_INTERRUPT_IDLE_TIMEOUT 50
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Flag that a matrix pin has changed state
+ *
+ * Intended to be called from a pin change interrupt. On the test platform
+ * this acts as the simulated interrupt source.
+ */
+void matrix_interrupt_signal(void);
+
+/** \brief Decide whether the matrix should be read on this pass
+ *
+ * Called by the matrix driver before reading its pins. Waits for the next
+ * interrupt while the matrix is armed and nothing has been signalled.
+ *
+ * \return true if the matrix should be scanned
+ */
+bool matrix_interrupt_should_scan(void);
+
+/** \brief Report the outcome of a scan to the idle tracking
+ *
+ * \param active true if any key is held or debouncing is still in progress
+ */
+void matrix_interrupt_scan_done(bool active);
+
+/** \brief Query whether the matrix is currently parked waiting for an interrupt
+ */
+bool matrix_interrupt_is_armed(void);
+
+/** \brief Timestamp of the most recent wake up, for latency measurements
+ */
+uint32_t matrix_interrupt_last_wake(void);
+
+/** \brief Number of wake ups since boot
+ */
+uint32_t matrix_interrupt_wake_count(void);
+
+/** \brief Matrix driver hook: drive all outputs and enable input interrupts
+ */
+void matrix_interrupt_arm_pins(void);
+
+/** \brief Matrix driver hook: disable input interrupts and restore scan state
+ */
+void matrix_interrupt_disarm_pins(void);
+
+/** \brief Matrix driver hook: check the armed inputs for any pressed key
+ *
+ * Used to catch edges that happened while arming, and as a polling fallback
+ * on platforms without pin change interrupts.
+ */
+bool matrix_interrupt_read_pins(void);
+
+/** \brief Platform hook: sleep until the next interrupt of any kind
+ */
+void matrix_interrupt_wait(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** \} */
@@ -0,0 +1,62 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "compiler_support.h"
+#include "eeprom.h"
+#include "nvm_dynamic_combo.h"
+#include "nvm_eeprom_eeconfig_internal.h"
+#include "nvm_eeprom_dynamic_combo_internal.h"
+
+STATIC_ASSERT(DYNAMIC_COMBO_EEPROM_ADDR >= EECONFIG_SIZE, "Dynamic combos are configured to use more EEPROM than is available.");
+STATIC_ASSERT(DYNAMIC_COMBO_EEPROM_ADDR + DYNAMIC_COMBO_EEPROM_SIZE <= TOTAL_EEPROM_BYTE_COUNT, "DYNAMIC_COMBO_EEPROM_ADDR is configured to use more space than what is available for the selected EEPROM driver");
+
+#define DYNAMIC_COMBO_EEPROM_BUFFER_ADDR (DYNAMIC_COMBO_EEPROM_ADDR + 2)
+#define DYNAMIC_COMBO_EEPROM_BUFFER_SIZE (DYNAMIC_COMBO_EEPROM_SIZE - 2)
+
+void nvm_dynamic_combo_erase(void) {
+    // No-op, nvm_eeconfig_erase() will have already erased EEPROM if necessary.
+}
+
+uint16_t nvm_dynamic_combo_read_header(void) {
+    return eeprom_read_word((const uint16_t *)(uintptr_t)DYNAMIC_COMBO_EEPROM_ADDR);
+}
+
+void nvm_dynamic_combo_update_header(uint16_t header) {
+    eeprom_update_word((uint16_t *)(uintptr_t)DYNAMIC_COMBO_EEPROM_ADDR, header);
+}
+
+uint32_t nvm_dynamic_combo_size(void) {
+    return DYNAMIC_COMBO_EEPROM_BUFFER_SIZE;
+}
+
+void nvm_dynamic_combo_read_buffer(uint32_t offset, uint32_t size, uint8_t *data) {
+    uint32_t available = offset < DYNAMIC_COMBO_EEPROM_BUFFER_SIZE ? DYNAMIC_COMBO_EEPROM_BUFFER_SIZE - offset : 0;
+    uint32_t length    = size < available ? size : available;
+    if (length) {
+        eeprom_read_block(data, (const void *)(uintptr_t)(DYNAMIC_COMBO_EEPROM_BUFFER_ADDR + offset), length);
+    }
+    for (uint32_t i = length; i < size; i++) {
+        data[i] = 0x00;
+    }
+}
+
+void nvm_dynamic_combo_update_buffer(uint32_t offset, uint32_t size, uint8_t *data) {
+    uint32_t available = offset < DYNAMIC_COMBO_EEPROM_BUFFER_SIZE ? DYNAMIC_COMBO_EEPROM_BUFFER_SIZE - offset : 0;
+    uint32_t length    = size < available ? size : available;
+    // One block, so that drivers which buffer their writes only commit once
+    if (length) {
+        eeprom_update_block(data, (void *)(uintptr_t)(DYNAMIC_COMBO_EEPROM_BUFFER_ADDR + offset), length);
+    }
+}
+
+void nvm_dynamic_combo_reset(void) {
+    void *  start     = (void *)(uintptr_t)(DYNAMIC_COMBO_EEPROM_BUFFER_ADDR);
+    int     remaining = DYNAMIC_COMBO_EEPROM_BUFFER_SIZE;
+    uint8_t dummy[16] = {0};
+    while (remaining > 0) {
+        int this_loop = remaining < (int)sizeof(dummy) ? remaining : (int)sizeof(dummy);
+        eeprom_update_block(dummy, start, this_loop);
+        start += this_loop;
+        remaining -= this_loop;
+    }
+}
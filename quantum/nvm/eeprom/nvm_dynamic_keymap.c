@@ -8,6 +8,12 @@
 #include "nvm_dynamic_keymap.h"
 #include "nvm_eeprom_eeconfig_internal.h"
 #include "nvm_eeprom_via_internal.h"
+#ifdef DYNAMIC_COMBO_ENABLE
+#    include "nvm_eeprom_dynamic_combo_internal.h"
+#endif
+#if defined(DYNAMIC_MACRO_ENABLE) && defined(DYNAMIC_MACRO_PERSIST)
+#    include "nvm_eeprom_dynamic_macro_internal.h"
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -23,11 +29,25 @@
 #endif
 
 #ifndef DYNAMIC_KEYMAP_EEPROM_MAX_ADDR
-#    define DYNAMIC_KEYMAP_EEPROM_MAX_ADDR (TOTAL_EEPROM_BYTE_COUNT - 1)
+#    if defined(DYNAMIC_MACRO_ENABLE) && defined(DYNAMIC_MACRO_PERSIST)
+#        define DYNAMIC_KEYMAP_EEPROM_MAX_ADDR (DYNAMIC_MACRO_EEPROM_ADDR - 1)
+#    elif defined(DYNAMIC_COMBO_ENABLE)
+#        define DYNAMIC_KEYMAP_EEPROM_MAX_ADDR (DYNAMIC_COMBO_EEPROM_ADDR - 1)
+#    else
+#        define DYNAMIC_KEYMAP_EEPROM_MAX_ADDR (TOTAL_EEPROM_BYTE_COUNT - 1)
+#    endif
 #endif
 
 STATIC_ASSERT(DYNAMIC_KEYMAP_EEPROM_MAX_ADDR <= (TOTAL_EEPROM_BYTE_COUNT - 1), "DYNAMIC_KEYMAP_EEPROM_MAX_ADDR is configured to use more space than what is available for the selected EEPROM driver");
 
+#ifdef DYNAMIC_COMBO_ENABLE
+STATIC_ASSERT(DYNAMIC_KEYMAP_EEPROM_MAX_ADDR < DYNAMIC_COMBO_EEPROM_ADDR, "DYNAMIC_KEYMAP_EEPROM_MAX_ADDR overlaps the dynamic combos");
+#endif
+
+#if defined(DYNAMIC_MACRO_ENABLE) && defined(DYNAMIC_MACRO_PERSIST)
+STATIC_ASSERT(DYNAMIC_KEYMAP_EEPROM_MAX_ADDR < DYNAMIC_MACRO_EEPROM_ADDR, "DYNAMIC_KEYMAP_EEPROM_MAX_ADDR overlaps the dynamic macros");
+#endif
+
 // Due to usage of uint16_t check for max 65535
 STATIC_ASSERT(DYNAMIC_KEYMAP_EEPROM_MAX_ADDR <= 65535, "DYNAMIC_KEYMAP_EEPROM_MAX_ADDR must be less than 65536");
 
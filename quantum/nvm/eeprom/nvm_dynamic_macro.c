@@ -0,0 +1,62 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifdef DYNAMIC_MACRO_PERSIST
+
+#    include "compiler_support.h"
+#    include "eeprom.h"
+#    include "nvm_dynamic_macro.h"
+#    include "nvm_eeprom_eeconfig_internal.h"
+#    include "nvm_eeprom_dynamic_macro_internal.h"
+
+STATIC_ASSERT(DYNAMIC_MACRO_EEPROM_ADDR >= EECONFIG_SIZE, "Dynamic macros are configured to use more EEPROM than is available.");
+STATIC_ASSERT(DYNAMIC_MACRO_EEPROM_ADDR + DYNAMIC_MACRO_EEPROM_SIZE <= TOTAL_EEPROM_BYTE_COUNT, "DYNAMIC_MACRO_EEPROM_ADDR is configured to use more space than what is available for the selected EEPROM driver");
+#    ifdef DYNAMIC_COMBO_ENABLE
+STATIC_ASSERT(DYNAMIC_MACRO_EEPROM_ADDR + DYNAMIC_MACRO_EEPROM_SIZE <= DYNAMIC_COMBO_EEPROM_ADDR, "DYNAMIC_MACRO_EEPROM_ADDR overlaps the dynamic combos");
+#    endif
+
+#    define DYNAMIC_MACRO_EEPROM_LENGTHS_ADDR (DYNAMIC_MACRO_EEPROM_ADDR + 4)
+#    define DYNAMIC_MACRO_EEPROM_BUFFER_ADDR (DYNAMIC_MACRO_EEPROM_ADDR + 8)
+#    define DYNAMIC_MACRO_EEPROM_BUFFER_SIZE (DYNAMIC_MACRO_EEPROM_SIZE - 8)
+
+void nvm_dynamic_macro_erase(void) {
+    // No-op, nvm_eeconfig_erase() will have already erased EEPROM if necessary.
+}
+
+uint32_t nvm_dynamic_macro_read_header(void) {
+    return eeprom_read_dword((const uint32_t *)(uintptr_t)DYNAMIC_MACRO_EEPROM_ADDR);
+}
+
+void nvm_dynamic_macro_update_header(uint32_t header) {
+    eeprom_update_dword((uint32_t *)(uintptr_t)DYNAMIC_MACRO_EEPROM_ADDR, header);
+}
+
+uint16_t nvm_dynamic_macro_read_length(uint8_t index) {
+    return eeprom_read_word((const uint16_t *)(uintptr_t)(DYNAMIC_MACRO_EEPROM_LENGTHS_ADDR + index * 2));
+}
+
+void nvm_dynamic_macro_update_length(uint8_t index, uint16_t length) {
+    eeprom_update_word((uint16_t *)(uintptr_t)(DYNAMIC_MACRO_EEPROM_LENGTHS_ADDR + index * 2), length);
+}
+
+void nvm_dynamic_macro_read_buffer(uint32_t offset, uint32_t size, uint8_t *data) {
+    uint32_t available = offset < DYNAMIC_MACRO_EEPROM_BUFFER_SIZE ? DYNAMIC_MACRO_EEPROM_BUFFER_SIZE - offset : 0;
+    uint32_t length    = size < available ? size : available;
+    if (length) {
+        eeprom_read_block(data, (const void *)(uintptr_t)(DYNAMIC_MACRO_EEPROM_BUFFER_ADDR + offset), length);
+    }
+    for (uint32_t i = length; i < size; i++) {
+        data[i] = 0x00;
+    }
+}
+
+void nvm_dynamic_macro_update_buffer(uint32_t offset, uint32_t size, uint8_t *data) {
+    uint32_t available = offset < DYNAMIC_MACRO_EEPROM_BUFFER_SIZE ? DYNAMIC_MACRO_EEPROM_BUFFER_SIZE - offset : 0;
+    uint32_t length    = size < available ? size : available;
+    // One block, so that drivers which buffer their writes only commit once
+    if (length) {
+        eeprom_update_block(data, (void *)(uintptr_t)(DYNAMIC_MACRO_EEPROM_BUFFER_ADDR + offset), length);
+    }
+}
+
+#endif
@@ -0,0 +1,13 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "dynamic_combo.h"
+
+// Dynamic combos are stored at the end of the EEPROM, behind a two byte header,
+// and the dynamic keymap macros stop right before them.
+#define DYNAMIC_COMBO_EEPROM_SIZE (2 + (DYNAMIC_COMBO_COUNT * DYNAMIC_COMBO_SLOT_SIZE))
+
+#ifndef DYNAMIC_COMBO_EEPROM_ADDR
+#    define DYNAMIC_COMBO_EEPROM_ADDR (TOTAL_EEPROM_BYTE_COUNT - DYNAMIC_COMBO_EEPROM_SIZE)
+#endif
@@ -0,0 +1,20 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "process_dynamic_macro.h"
+#ifdef DYNAMIC_COMBO_ENABLE
+#    include "nvm_eeprom_dynamic_combo_internal.h"
+#endif
+
+// Dynamic macros are stored right before the dynamic combos, or at the end of the EEPROM,
+// behind a four byte header and the lengths of both macros.
+#define DYNAMIC_MACRO_EEPROM_SIZE (4 + 4 + DYNAMIC_MACRO_BUFFER_SIZE)
+
+#ifndef DYNAMIC_MACRO_EEPROM_ADDR
+#    ifdef DYNAMIC_COMBO_ENABLE
+#        define DYNAMIC_MACRO_EEPROM_ADDR (DYNAMIC_COMBO_EEPROM_ADDR - DYNAMIC_MACRO_EEPROM_SIZE)
+#    else
+#        define DYNAMIC_MACRO_EEPROM_ADDR (TOTAL_EEPROM_BYTE_COUNT - DYNAMIC_MACRO_EEPROM_SIZE)
+#    endif
+#endif
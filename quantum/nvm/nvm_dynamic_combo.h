@@ -0,0 +1,18 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void nvm_dynamic_combo_erase(void);
+
+uint16_t nvm_dynamic_combo_read_header(void);
+void     nvm_dynamic_combo_update_header(uint16_t header);
+
+uint32_t nvm_dynamic_combo_size(void);
+
+void nvm_dynamic_combo_read_buffer(uint32_t offset, uint32_t size, uint8_t *data);
+void nvm_dynamic_combo_update_buffer(uint32_t offset, uint32_t size, uint8_t *data);
+
+void nvm_dynamic_combo_reset(void);
@@ -0,0 +1,17 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void nvm_dynamic_macro_erase(void);
+
+uint32_t nvm_dynamic_macro_read_header(void);
+void     nvm_dynamic_macro_update_header(uint32_t header);
+
+uint16_t nvm_dynamic_macro_read_length(uint8_t index);
+void     nvm_dynamic_macro_update_length(uint8_t index, uint16_t length);
+
+void nvm_dynamic_macro_read_buffer(uint32_t offset, uint32_t size, uint8_t *data);
+void nvm_dynamic_macro_update_buffer(uint32_t offset, uint32_t size, uint8_t *data);
@@ -16,9 +16,12 @@
 
 #include "process_combo.h"
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 #include "process_auto_shift.h"
 #include "caps_word.h"
 #include "timer.h"
+#include "debug.h"
 #include "wait.h"
 #include "keyboard.h"
 #include "keymap_common.h"
@@ -120,11 +123,19 @@ static queued_combo_t combo_buffer[COMBO_BUFFER_LENGTH];
         do {                        \
             combo->disabled = true; \
         } while (0)
-#    define RESET_COMBO_STATE(combo) \
-        do {                         \
-            combo->disabled = false; \
-            combo->state    = 0;     \
-        } while (0)
+#    ifdef COMBO_BITMASK_STATE
+#        define RESET_COMBO_STATE(combo)                           \
+            do {                                                   \
+                combo->disabled = false;                           \
+                combo->state    = (combo_bitmask_t){0};            \
+            } while (0)
+#    else
+#        define RESET_COMBO_STATE(combo) \
+            do {                         \
+                combo->disabled = false; \
+                combo->state    = 0;     \
+            } while (0)
+#    endif
 #else
 /* flags are at the two high bits of state. */
 #    define COMBO_ACTIVE(combo) (combo->state & 0x80)
@@ -204,7 +215,7 @@ void clear_combos(void) {
     longest_term   = 0;
     for (index = 0; index < combo_count(); ++index) {
         combo_t *combo = combo_get(index);
-        if (!COMBO_ACTIVE(combo)) {
+        if (combo && !COMBO_ACTIVE(combo)) {
             RESET_COMBO_STATE(combo);
         }
     }
@@ -234,6 +245,8 @@ static inline void dump_key_buffer(void) {
         if (!record->keycode && qrecord->combo_index != (uint16_t)-1) {
             process_combo_event(qrecord->combo_index, true);
         } else {
+            // Looked up before the keys ahead of it were processed
+            clear_record_keycode_cache(record);
 #ifndef NO_ACTION_TAPPING
             action_tapping_process(*record);
 #else
@@ -264,7 +277,11 @@ static inline void dump_key_buffer(void) {
     key_buffer_next = key_buffer_size = 0;
 }
 
-#define NO_COMBO_KEYS_ARE_DOWN (0 == COMBO_STATE(combo))
+#ifdef COMBO_BITMASK_STATE
+#    define NO_COMBO_KEYS_ARE_DOWN combo_bitmask_empty(&combo->state)
+#else
+#    define NO_COMBO_KEYS_ARE_DOWN (0 == COMBO_STATE(combo))
+#endif
 #define ALL_COMBO_KEYS_ARE_DOWN(state, key_count) (((1 << key_count) - 1) == state)
 #define ONLY_ONE_KEY_IS_DOWN(state) !(state & (state - 1))
 #define KEY_NOT_YET_RELEASED(state, key_index) ((1 << key_index) & state)
@@ -277,6 +294,133 @@ static inline void dump_key_buffer(void) {
         state &= ~(1 << key_index);    \
     } while (0)
 
+/* A key of the combo being processed. */
+typedef struct {
+    uint16_t index; // position in the combo's key list
+    uint8_t  count; // number of keys in the combo
+#ifdef COMBO_BITMASK_STATE
+    uint16_t bit; // bit of the keycode in the combo bitmasks
+#endif
+} combo_key_t;
+
+#if defined(COMBO_BITMASK_STATE) && !defined(COMBO_MUST_PRESS_IN_ORDER) && !defined(COMBO_MUST_PRESS_IN_ORDER_PER_COMBO) && !defined(COMBO_PROCESS_KEY_RELEASE) && !defined(COMBO_PROCESS_KEY_REPRESS)
+/* Only the in order check and the release and repress callbacks need the
+ * position of a key in its combo, the bitmasks do without. */
+#    define COMBO_KEY_INDEX_UNUSED
+#endif
+
+#ifdef COMBO_BITMASK_STATE
+#    define COMBO_NO_KEY_BIT UINT16_MAX
+
+/* Every distinct combo keycode, sorted, the position of a keycode is its bit. */
+static uint16_t combo_keycodes[COMBO_BITMASK_KEYS];
+static uint16_t combo_keycodes_size  = 0;
+static uint16_t combo_bitmasks_count = 0;
+static bool     combo_bitmasks_valid = false;
+
+static inline void combo_bitmask_set(combo_bitmask_t *bitmask, uint16_t bit) {
+    bitmask->words[bit / 32] |= (uint32_t)1 << (bit % 32);
+}
+
+static inline void combo_bitmask_clear(combo_bitmask_t *bitmask, uint16_t bit) {
+    bitmask->words[bit / 32] &= ~((uint32_t)1 << (bit % 32));
+}
+
+static inline bool combo_bitmask_test(const combo_bitmask_t *bitmask, uint16_t bit) {
+    return bit != COMBO_NO_KEY_BIT && (bitmask->words[bit / 32] & ((uint32_t)1 << (bit % 32)));
+}
+
+static inline bool combo_bitmask_equal(const combo_bitmask_t *a, const combo_bitmask_t *b) {
+    for (uint8_t i = 0; i < COMBO_BITMASK_WORDS; i++) {
+        if (a->words[i] != b->words[i]) return false;
+    }
+    return true;
+}
+
+static inline bool combo_bitmask_empty(const combo_bitmask_t *bitmask) {
+    for (uint8_t i = 0; i < COMBO_BITMASK_WORDS; i++) {
+        if (bitmask->words[i]) return false;
+    }
+    return true;
+}
+
+static inline uint16_t combo_bitmask_count(const combo_bitmask_t *bitmask) {
+    uint16_t count = 0;
+    for (uint8_t i = 0; i < COMBO_BITMASK_WORDS; i++) {
+        count += __builtin_popcountl(bitmask->words[i]);
+    }
+    return count;
+}
+
+static uint16_t combo_key_bit(uint16_t keycode) {
+    uint16_t low = 0, high = combo_keycodes_size;
+    while (low < high) {
+        const uint16_t mid = low + (high - low) / 2;
+        if (combo_keycodes[mid] < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < combo_keycodes_size && combo_keycodes[low] == keycode) ? low : COMBO_NO_KEY_BIT;
+}
+
+/* Assigns the bits and computes the mask of every combo. A combo with a key
+ * past COMBO_BITMASK_KEYS distinct keycodes gets an empty mask and never fires. */
+static void combo_bitmasks_build(void) {
+    combo_bitmasks_count = combo_count();
+    combo_keycodes_size  = 0;
+    combo_bitmasks_valid = true;
+
+    for (uint16_t idx = 0; idx < combo_bitmasks_count; ++idx) {
+        const uint16_t *keys = combo_get(idx)->keys;
+        uint16_t        keycode;
+        for (uint8_t i = 0; (keycode = pgm_read_word(&keys[i])) != COMBO_END; ++i) {
+            const uint16_t pos = combo_key_bit(keycode);
+            if (pos != COMBO_NO_KEY_BIT || combo_keycodes_size >= COMBO_BITMASK_KEYS) {
+                continue;
+            }
+            // Insertion sort, this only runs when the combos change
+            uint16_t j = combo_keycodes_size++;
+            for (; j > 0 && combo_keycodes[j - 1] > keycode; --j) {
+                combo_keycodes[j] = combo_keycodes[j - 1];
+            }
+            combo_keycodes[j] = keycode;
+        }
+    }
+
+    for (uint16_t idx = 0; idx < combo_bitmasks_count; ++idx) {
+        combo_t *       combo = combo_get(idx);
+        const uint16_t *keys  = combo->keys;
+        uint16_t        keycode;
+
+        memset(&combo->mask, 0, sizeof(combo_bitmask_t));
+        memset(&combo->state, 0, sizeof(combo_bitmask_t));
+        for (uint8_t i = 0; (keycode = pgm_read_word(&keys[i])) != COMBO_END; ++i) {
+            const uint16_t bit = combo_key_bit(keycode);
+            if (bit == COMBO_NO_KEY_BIT) {
+                dprintf("combo: combo %u needs a larger COMBO_BITMASK_KEYS\n", idx);
+                memset(&combo->mask, 0, sizeof(combo_bitmask_t));
+                break;
+            }
+            combo_bitmask_set(&combo->mask, bit);
+        }
+    }
+}
+
+#    define COMBO_ALL_KEYS_DOWN(combo, key) combo_bitmask_equal(&(combo)->state, &(combo)->mask)
+#    define COMBO_ONLY_ONE_KEY_DOWN(combo) (combo_bitmask_count(&(combo)->state) == 1)
+#    define COMBO_KEY_NOT_YET_RELEASED(combo, key) combo_bitmask_test(&(combo)->state, (key).bit)
+#    define COMBO_KEY_DOWN(combo, key) combo_bitmask_set(&(combo)->state, (key).bit)
+#    define COMBO_KEY_UP(combo, key) combo_bitmask_clear(&(combo)->state, (key).bit)
+#else
+#    define COMBO_ALL_KEYS_DOWN(combo, key) ALL_COMBO_KEYS_ARE_DOWN(COMBO_STATE(combo), (key).count)
+#    define COMBO_ONLY_ONE_KEY_DOWN(combo) ONLY_ONE_KEY_IS_DOWN(COMBO_STATE(combo))
+#    define COMBO_KEY_NOT_YET_RELEASED(combo, key) KEY_NOT_YET_RELEASED(COMBO_STATE(combo), (key).index)
+#    define COMBO_KEY_DOWN(combo, key) KEY_STATE_DOWN((combo)->state, (key).index)
+#    define COMBO_KEY_UP(combo, key) KEY_STATE_UP((combo)->state, (key).index)
+#endif
+
 static inline void _find_key_index_and_count(const uint16_t *keys, uint16_t keycode, uint16_t *key_index, uint8_t *key_count) {
     while (true) {
         uint16_t key = pgm_read_word(&keys[*key_count]);
@@ -295,7 +439,9 @@ void drop_combo_from_buffer(uint16_t combo_index) {
 
         if (qcombo->combo_index == combo_index) {
             combo_t *combo = combo_get(combo_index);
-            DISABLE_COMBO(combo);
+            if (combo) {
+                DISABLE_COMBO(combo);
+            }
 
             if (i == combo_buffer_read) {
                 INCREMENT_MOD(combo_buffer_read);
@@ -315,7 +461,9 @@ void apply_combo(uint16_t combo_index, combo_t *combo) {
     }
 
     // state to check against so we find the last key of the combo from the buffer
-#if defined(EXTRA_EXTRA_LONG_COMBOS)
+#if defined(COMBO_BITMASK_STATE)
+    combo_bitmask_t state = {0};
+#elif defined(EXTRA_EXTRA_LONG_COMBOS)
     uint32_t state = 0;
 #elif defined(EXTRA_LONG_COMBOS)
     uint16_t state         = 0;
@@ -328,6 +476,16 @@ void apply_combo(uint16_t combo_index, combo_t *combo) {
         keyrecord_t *    record  = &qrecord->record;
         uint16_t         keycode = qrecord->keycode;
 
+#ifdef COMBO_BITMASK_STATE
+        const uint16_t bit = combo_key_bit(keycode);
+        if (!combo_bitmask_test(&combo->mask, bit)) {
+            // key not part of this combo
+            continue;
+        }
+
+        combo_bitmask_set(&state, bit);
+        if (combo_bitmask_equal(&state, &combo->mask)) {
+#else
         uint8_t  key_count = 0;
         uint16_t key_index = -1;
         _find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
@@ -339,6 +497,7 @@ void apply_combo(uint16_t combo_index, combo_t *combo) {
 
         KEY_STATE_DOWN(state, key_index);
         if (ALL_COMBO_KEYS_ARE_DOWN(state, key_count)) {
+#endif
             // this in the end executes the combo when the key_buffer is dumped.
             record->keycode    = combo->keycode;
             record->event.type = COMBO_EVENT;
@@ -363,6 +522,11 @@ static inline void apply_combos(void) {
         queued_combo_t *buffered_combo = &combo_buffer[i];
         combo_t *       combo          = combo_get(buffered_combo->combo_index);
 
+        if (!combo) {
+            // The combo was removed while buffered
+            drop_combo_from_buffer(buffered_combo->combo_index);
+            continue;
+        }
 #ifdef COMBO_MUST_TAP_PER_COMBO
         if (get_combo_must_tap(buffered_combo->combo_index, combo)) {
             // Tap-only combos are applied on key release only, so let's drop 'em here.
@@ -401,12 +565,21 @@ combo_t *overlaps(combo_t *combo1, combo_t *combo2) {
 }
 
 #if defined(COMBO_MUST_PRESS_IN_ORDER) || defined(COMBO_MUST_PRESS_IN_ORDER_PER_COMBO)
-static bool keys_pressed_in_order(uint16_t combo_index, combo_t *combo, uint16_t key_index, uint16_t keycode, keyrecord_t *record) {
+static bool keys_pressed_in_order(uint16_t combo_index, combo_t *combo, combo_key_t key, uint16_t keycode, keyrecord_t *record) {
 #    ifdef COMBO_MUST_PRESS_IN_ORDER_PER_COMBO
     if (!get_combo_must_press_in_order(combo_index, combo)) {
         return true;
     }
 #    endif
+#    ifdef COMBO_BITMASK_STATE
+    // Exactly the keys listed before this one must be down
+    combo_bitmask_t before = {0};
+    for (uint16_t i = 0; i < key.index; i++) {
+        combo_bitmask_set(&before, combo_key_bit(pgm_read_word(&combo->keys[i])));
+    }
+    return combo_bitmask_equal(&before, &combo->state);
+#    else
+    const uint16_t key_index = key.index;
     if (
         // The `state` bit for the key being pressed.
         (1 << key_index) ==
@@ -419,22 +592,14 @@ static bool keys_pressed_in_order(uint16_t combo_index, combo_t *combo, uint16_t
         return true;
     }
     return false;
+#    endif
 }
 #endif
 
-static combo_key_action_t process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index) {
-    uint8_t  key_count = 0;
-    uint16_t key_index = -1;
-    _find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
-
-    /* Continue processing if key isn't part of current combo. */
-    if (-1 == (int16_t)key_index) {
-        return COMBO_KEY_NOT_PRESSED;
-    }
-
+static combo_key_action_t process_combo_key(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index, combo_key_t key) {
     bool key_is_part_of_combo = (!COMBO_DISABLED(combo) && is_combo_enabled()
 #if defined(COMBO_MUST_PRESS_IN_ORDER) || defined(COMBO_MUST_PRESS_IN_ORDER_PER_COMBO)
-                                 && keys_pressed_in_order(combo_index, combo, key_index, keycode, record)
+                                 && keys_pressed_in_order(combo_index, combo, key, keycode, record)
 #endif
 #ifdef COMBO_SHOULD_TRIGGER
                                  && combo_should_trigger(combo_index, combo, keycode, record)
@@ -444,12 +609,12 @@ static combo_key_action_t process_single_combo(combo_t *combo, uint16_t keycode,
     if (record->event.pressed && key_is_part_of_combo) {
         uint16_t time = _get_combo_term(combo_index, combo);
         if (!COMBO_ACTIVE(combo)) {
-            KEY_STATE_DOWN(combo->state, key_index);
+            COMBO_KEY_DOWN(combo, key);
             if (longest_term < time) {
                 longest_term = time;
             }
         }
-        if (ALL_COMBO_KEYS_ARE_DOWN(COMBO_STATE(combo), key_count)) {
+        if (COMBO_ALL_KEYS_DOWN(combo, key)) {
             /* Combo was fully pressed */
             /* Buffer the combo so we can fire it after COMBO_TERM */
 
@@ -468,6 +633,9 @@ static combo_key_action_t process_single_combo(combo_t *combo, uint16_t keycode,
                     queued_combo_t *qcombo         = &combo_buffer[combo_buffer_i];
                     combo_t *       buffered_combo = combo_get(qcombo->combo_index);
 
+                    if (!buffered_combo) {
+                        continue;
+                    }
                     if ((drop = overlaps(buffered_combo, combo))) {
                         DISABLE_COMBO(drop);
                         if (drop == combo) {
@@ -496,15 +664,15 @@ static combo_key_action_t process_single_combo(combo_t *combo, uint16_t keycode,
 #ifdef COMBO_PROCESS_KEY_REPRESS
     } else if (record->event.pressed) {
         if (COMBO_ACTIVE(combo)) {
-            if (process_combo_key_repress(combo_index, combo, key_index, keycode)) {
-                KEY_STATE_DOWN(combo->state, key_index);
+            if (process_combo_key_repress(combo_index, combo, key.index, keycode)) {
+                COMBO_KEY_DOWN(combo, key);
                 return COMBO_KEY_REPRESSED;
             }
         }
 #endif
     } else {
         // chord releases
-        if (!COMBO_ACTIVE(combo) && ALL_COMBO_KEYS_ARE_DOWN(COMBO_STATE(combo), key_count)) {
+        if (!COMBO_ACTIVE(combo) && COMBO_ALL_KEYS_DOWN(combo, key)) {
             /* First key quickly released */
             if (COMBO_DISABLED(combo) || _get_combo_must_hold(combo_index, combo)) {
                 // combo wasn't tappable, disable it and drop it from buffer.
@@ -517,26 +685,26 @@ static combo_key_action_t process_single_combo(combo_t *combo, uint16_t keycode,
                 apply_combo(combo_index, combo);
                 apply_combos(); // also apply other prepared combos and dump key buffer
 #    ifdef COMBO_PROCESS_KEY_RELEASE
-                if (process_combo_key_release(combo_index, combo, key_index, keycode)) {
+                if (process_combo_key_release(combo_index, combo, key.index, keycode)) {
                     release_combo(combo_index, combo);
                 }
 #    endif
             }
 #endif
-        } else if (COMBO_ACTIVE(combo) && ONLY_ONE_KEY_IS_DOWN(COMBO_STATE(combo)) && KEY_NOT_YET_RELEASED(COMBO_STATE(combo), key_index)) {
+        } else if (COMBO_ACTIVE(combo) && COMBO_ONLY_ONE_KEY_DOWN(combo) && COMBO_KEY_NOT_YET_RELEASED(combo, key)) {
             /* last key released */
             release_combo(combo_index, combo);
             key_is_part_of_combo = true;
 
 #ifdef COMBO_PROCESS_KEY_RELEASE
-            process_combo_key_release(combo_index, combo, key_index, keycode);
+            process_combo_key_release(combo_index, combo, key.index, keycode);
 #endif
-        } else if (COMBO_ACTIVE(combo) && KEY_NOT_YET_RELEASED(COMBO_STATE(combo), key_index)) {
+        } else if (COMBO_ACTIVE(combo) && COMBO_KEY_NOT_YET_RELEASED(combo, key)) {
             /* first or middle key released */
             key_is_part_of_combo = true;
 
 #ifdef COMBO_PROCESS_KEY_RELEASE
-            if (process_combo_key_release(combo_index, combo, key_index, keycode)) {
+            if (process_combo_key_release(combo_index, combo, key.index, keycode)) {
                 release_combo(combo_index, combo);
             }
 #endif
@@ -545,12 +713,134 @@ static combo_key_action_t process_single_combo(combo_t *combo, uint16_t keycode,
             key_is_part_of_combo = false;
         }
 
-        KEY_STATE_UP(combo->state, key_index);
+        COMBO_KEY_UP(combo, key);
     }
 
     return key_is_part_of_combo ? COMBO_KEY_PRESSED : COMBO_KEY_NOT_PRESSED;
 }
 
+static combo_key_action_t process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index, combo_key_t key) {
+#ifdef COMBO_BITMASK_STATE
+    /* Continue processing if key isn't part of current combo. */
+    if (!combo_bitmask_test(&combo->mask, key.bit)) {
+        return COMBO_KEY_NOT_PRESSED;
+    }
+#    ifdef COMBO_KEY_INDEX_UNUSED
+    return process_combo_key(combo, keycode, record, combo_index, key);
+#    endif
+#endif
+
+    uint8_t  key_count = 0;
+    uint16_t key_index = -1;
+    _find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
+
+    /* Continue processing if key isn't part of current combo. */
+    if (-1 == (int16_t)key_index) {
+        return COMBO_KEY_NOT_PRESSED;
+    }
+
+    key.index = key_index;
+    key.count = key_count;
+    return process_combo_key(combo, keycode, record, combo_index, key);
+}
+
+#ifdef COMBO_KEYCODE_INDEX
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+    uint8_t  key_index;
+    uint8_t  key_count;
+} combo_index_entry_t;
+
+// Every key of every combo, sorted by keycode then by combo index
+static combo_index_entry_t combo_index[COMBO_KEYCODE_INDEX_SIZE];
+static uint16_t            combo_index_size  = 0;
+static uint16_t            combo_index_count = 0;
+static bool                combo_index_valid = false;
+
+static int combo_index_compare(const void *a, const void *b) {
+    const combo_index_entry_t *entry_a = a;
+    const combo_index_entry_t *entry_b = b;
+    if (entry_a->keycode != entry_b->keycode) {
+        return entry_a->keycode < entry_b->keycode ? -1 : 1;
+    }
+    return (int)entry_a->combo_index - (int)entry_b->combo_index;
+}
+
+/* If the combos don't fit, the index is left empty and every combo is checked. */
+static void combo_index_build(void) {
+    combo_index_count = combo_count();
+    combo_index_size  = 0;
+    combo_index_valid = true;
+
+    for (uint16_t idx = 0; idx < combo_index_count; ++idx) {
+        const uint16_t *keys      = combo_get(idx)->keys;
+        uint8_t         key_count = 0;
+        while (pgm_read_word(&keys[key_count]) != COMBO_END) {
+            key_count++;
+        }
+
+        for (uint8_t key_index = 0; key_index < key_count; ++key_index) {
+            const uint16_t keycode   = pgm_read_word(&keys[key_index]);
+            bool           duplicate = false;
+            // A key listed twice counts at its last position, as in _find_key_index_and_count()
+            for (uint8_t later = key_index + 1; later < key_count; ++later) {
+                duplicate |= pgm_read_word(&keys[later]) == keycode;
+            }
+            if (duplicate) {
+                continue;
+            }
+
+            if (combo_index_size >= COMBO_KEYCODE_INDEX_SIZE) {
+                dprintf("combo: %u combos need a larger COMBO_KEYCODE_INDEX_SIZE\n", combo_index_count);
+                combo_index_size = 0;
+                return;
+            }
+            combo_index[combo_index_size++] = (combo_index_entry_t){
+                .keycode     = keycode,
+                .combo_index = idx,
+                .key_index   = key_index,
+                .key_count   = key_count,
+            };
+        }
+    }
+
+    qsort(combo_index, combo_index_size, sizeof(combo_index_entry_t), combo_index_compare);
+}
+
+/* Finds the entries of the combos containing keycode, in combo order. */
+static const combo_index_entry_t *combo_index_find(uint16_t keycode, const combo_index_entry_t **end) {
+    uint16_t low = 0, high = combo_index_size;
+    while (low < high) {
+        const uint16_t mid = low + (high - low) / 2;
+        if (combo_index[mid].keycode < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    const combo_index_entry_t *first = &combo_index[low];
+    *end                             = first;
+    while (*end < &combo_index[combo_index_size] && (*end)->keycode == keycode) {
+        (*end)++;
+    }
+    return first;
+}
+
+#endif
+
+#if defined(COMBO_KEYCODE_INDEX) || defined(COMBO_BITMASK_STATE)
+void combo_keycode_index_invalidate(void) {
+#    ifdef COMBO_KEYCODE_INDEX
+    combo_index_valid = false;
+#    endif
+#    ifdef COMBO_BITMASK_STATE
+    combo_bitmasks_valid = false;
+#    endif
+}
+#endif
+
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
     uint8_t is_combo_key          = COMBO_KEY_NOT_PRESSED;
     bool    no_combo_keys_pressed = true;
@@ -581,10 +871,36 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     }
 #endif
 
-    for (uint16_t idx = 0; idx < combo_count(); ++idx) {
-        combo_t *combo = combo_get(idx);
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+    combo_key_t key = {0};
+#ifdef COMBO_BITMASK_STATE
+    if (!combo_bitmasks_valid || combo_bitmasks_count != combo_count()) {
+        combo_bitmasks_build();
+    }
+    key.bit = combo_key_bit(keycode);
+
+    // A keycode without a bit is in none of the combo masks
+    if (key.bit != COMBO_NO_KEY_BIT)
+#endif
+    {
+#ifdef COMBO_KEYCODE_INDEX
+        if (!combo_index_valid || combo_index_count != combo_count()) {
+            combo_index_build();
+        }
+        // The end marker matches every combo, leave it to the full scan
+        if (keycode != COMBO_END && combo_index_size > 0) {
+            const combo_index_entry_t *end;
+            for (const combo_index_entry_t *entry = combo_index_find(keycode, &end); entry < end; ++entry) {
+                key.index = entry->key_index;
+                key.count = entry->key_count;
+                is_combo_key |= process_combo_key(combo_get(entry->combo_index), keycode, record, entry->combo_index, key);
+            }
+        } else
+#endif
+            for (uint16_t idx = 0; idx < combo_count(); ++idx) {
+                combo_t *combo = combo_get(idx);
+                is_combo_key |= process_single_combo(combo, keycode, record, idx, key);
+                no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+            }
     }
 
     if (record->event.pressed && is_combo_key) {
@@ -672,3 +988,16 @@ void combo_toggle(void) {
 bool is_combo_enabled(void) {
     return b_combo_enable;
 }
+
+bool combo_is_idle(void) {
+    if (combo_buffer_read != combo_buffer_write || key_buffer_size > 0) {
+        return false;
+    }
+    for (uint16_t idx = 0; idx < combo_count(); ++idx) {
+        combo_t *combo = combo_get(idx);
+        if (combo && (COMBO_ACTIVE(combo) || !NO_COMBO_KEYS_ARE_DOWN)) {
+            return false;
+        }
+    }
+    return true;
+}
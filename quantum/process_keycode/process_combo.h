@@ -38,6 +38,24 @@
 #ifndef COMBO_BUFFER_LENGTH
 #    define COMBO_BUFFER_LENGTH 4
 #endif
+#ifndef COMBO_KEYCODE_INDEX_SIZE
+#    define COMBO_KEYCODE_INDEX_SIZE 64
+#endif
+
+#ifdef COMBO_BITMASK_STATE
+#    ifdef EXTRA_SHORT_COMBOS
+#        error "COMBO_BITMASK_STATE cannot be used with EXTRA_SHORT_COMBOS"
+#    endif
+#    ifndef COMBO_BITMASK_KEYS
+#        define COMBO_BITMASK_KEYS 64
+#    endif
+#    define COMBO_BITMASK_WORDS ((COMBO_BITMASK_KEYS + 31) / 32)
+
+/* One bit per distinct keycode used by the combos. */
+typedef struct {
+    uint32_t words[COMBO_BITMASK_WORDS];
+} combo_bitmask_t;
+#endif
 
 typedef struct combo_t {
     const uint16_t *keys;
@@ -47,7 +65,10 @@ typedef struct combo_t {
 #else
     bool     disabled;
     bool     active;
-#    if defined(EXTRA_EXTRA_LONG_COMBOS)
+#    if defined(COMBO_BITMASK_STATE)
+    combo_bitmask_t state;
+    combo_bitmask_t mask;
+#    elif defined(EXTRA_EXTRA_LONG_COMBOS)
     uint32_t state;
 #    elif defined(EXTRA_LONG_COMBOS)
     uint16_t state;
@@ -81,3 +102,12 @@ void combo_enable(void);
 void combo_disable(void);
 void combo_toggle(void);
 bool is_combo_enabled(void);
+/* No combo is buffered, active or partly pressed, so the combo list can change. */
+bool combo_is_idle(void);
+
+#if defined(COMBO_KEYCODE_INDEX) || defined(COMBO_BITMASK_STATE)
+/* Rebuild the keycode index and key bits on the next key event, after combos changed. */
+void combo_keycode_index_invalidate(void);
+#else
+#    define combo_keycode_index_invalidate()
+#endif
@@ -21,8 +21,13 @@
 #include "action_layer.h"
 #include "keycodes.h"
 #include "debug.h"
+#include "timer.h"
 #include "wait.h"
 
+#ifdef DYNAMIC_MACRO_PERSIST
+#    include "nvm_dynamic_macro.h"
+#endif
+
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -89,40 +94,234 @@ __attribute__((weak)) bool dynamic_macro_valid_key_user(uint16_t keycode, keyrec
 #define DYNAMIC_MACRO_CURRENT_LENGTH(BEGIN, POINTER) ((int)(direction * ((POINTER) - (BEGIN))))
 #define DYNAMIC_MACRO_CURRENT_CAPACITY(BEGIN, END2) ((int)(direction * ((END2) - (BEGIN)) + 1))
 
+/* The key events are stored as a stream of bytes. Each event starts
+ * with a header byte:
+ *
+ *   bit 7     the key is pressed
+ *   bit 6     the key follows, otherwise it is the same as the one of
+ *             the previous event
+ *   bit 5     the delay follows
+ *   bit 4     tap.interrupted
+ *   bits 0-3  tap.count
+ *
+ * The key is the event type, row and column, one byte each. Bit 7 of
+ * the type is set when the keycode of the record follows, high byte
+ * first. The delay is the time since the previous event in
+ * milliseconds, as a varint of 7 bits per byte, low bits first. It is
+ * only recorded with DYNAMIC_MACRO_TIMING.
+ *
+ * So a key press usually takes four bytes, and its release one.
+ */
+#define DYNAMIC_MACRO_PRESSED 0x80
+#define DYNAMIC_MACRO_NEW_KEY 0x40
+#define DYNAMIC_MACRO_HAS_DELAY 0x20
+#define DYNAMIC_MACRO_INTERRUPTED 0x10
+#define DYNAMIC_MACRO_TAP_COUNT 0x0F
+#define DYNAMIC_MACRO_HAS_KEYCODE 0x80
+
+/* Header, key with a keycode and a 16 bit delay */
+#define DYNAMIC_MACRO_MAX_EVENT_SIZE (1 + 5 + 3)
+
+typedef struct {
+    uint8_t  type;
+    uint8_t  row;
+    uint8_t  col;
+    uint16_t keycode;
+} dynamic_macro_key_t;
+
+/* The key and time of the last recorded event. */
+static dynamic_macro_key_t last_key;
+static uint16_t            last_time;
+
+/* Where the macro being recorded ends when the recording stops, right
+ * after its last key-up event. */
+static uint8_t *last_release_end = NULL;
+
+/* Set once an event didn't fit, so that smaller events after it aren't
+ * recorded out of order. */
+static bool macro_full = false;
+
+static dynamic_macro_key_t dynamic_macro_key(keyrecord_t *record) {
+    dynamic_macro_key_t key = {
+        .type = record->event.type,
+        .row  = record->event.key.row,
+        .col  = record->event.key.col,
+    };
+#if defined(COMBO_ENABLE) || defined(REPEAT_KEY_ENABLE)
+    key.keycode = record->keycode;
+#endif
+    return key;
+}
+
+/**
+ * Encode a key event.
+ *
+ * @param record[in] The key event.
+ * @param first[in]  Whether it is the first event of the macro.
+ * @param data[out]  Room for DYNAMIC_MACRO_MAX_EVENT_SIZE bytes.
+ * @return The number of bytes used.
+ */
+static uint8_t dynamic_macro_encode(keyrecord_t *record, bool first, uint8_t *data) {
+    dynamic_macro_key_t key    = dynamic_macro_key(record);
+    uint8_t             length = 1;
+
+    data[0] = record->event.pressed ? DYNAMIC_MACRO_PRESSED : 0;
+#ifndef NO_ACTION_TAPPING
+    data[0] |= (record->tap.interrupted ? DYNAMIC_MACRO_INTERRUPTED : 0) | (record->tap.count & DYNAMIC_MACRO_TAP_COUNT);
+#endif
+
+    if (first || key.type != last_key.type || key.row != last_key.row || key.col != last_key.col || key.keycode != last_key.keycode) {
+        data[0] |= DYNAMIC_MACRO_NEW_KEY;
+        data[length++] = key.type | (key.keycode ? DYNAMIC_MACRO_HAS_KEYCODE : 0);
+        data[length++] = key.row;
+        data[length++] = key.col;
+        if (key.keycode) {
+            data[length++] = key.keycode >> 8;
+            data[length++] = key.keycode & 0xFF;
+        }
+    }
+
+#ifdef DYNAMIC_MACRO_TIMING
+    uint16_t delay = first ? 0 : TIMER_DIFF_16(record->event.time, last_time);
+    if (delay) {
+        data[0] |= DYNAMIC_MACRO_HAS_DELAY;
+        while (delay > 0x7F) {
+            data[length++] = (delay & 0x7F) | 0x80;
+            delay >>= 7;
+        }
+        data[length++] = delay;
+    }
+#endif
+
+    return length;
+}
+
+/* Reads one byte, unless the end of the macro has been reached. */
+static inline bool dynamic_macro_read(uint8_t **macro_pointer, uint8_t *macro_end, int8_t direction, uint8_t *data) {
+    if (*macro_pointer == macro_end) {
+        return false;
+    }
+    *data = **macro_pointer;
+    *macro_pointer += direction;
+    return true;
+}
+
+/**
+ * Decode the next key event of a macro.
+ *
+ * @param macro_pointer[in,out] The position of the event in the buffer.
+ * @param macro_end[in]         The element after the last macro buffer element.
+ * @param direction[in]         Either +1 or -1, which way to iterate the buffer.
+ * @param key[in,out]           The key of the previous event.
+ * @param record[out]           The key event, without its time.
+ * @param delay[out]            The delay before the event, in milliseconds.
+ * @return false if the event is cut off by the end of the macro, or
+ *         its delay doesn't fit in 16 bits.
+ */
+static bool dynamic_macro_decode(uint8_t **macro_pointer, uint8_t *macro_end, int8_t direction, dynamic_macro_key_t *key, keyrecord_t *record, uint16_t *delay) {
+    uint8_t header;
+    if (!dynamic_macro_read(macro_pointer, macro_end, direction, &header)) {
+        return false;
+    }
+
+    if (header & DYNAMIC_MACRO_NEW_KEY) {
+        uint8_t type, row, col, high = 0, low = 0;
+        if (!dynamic_macro_read(macro_pointer, macro_end, direction, &type) || !dynamic_macro_read(macro_pointer, macro_end, direction, &row) || !dynamic_macro_read(macro_pointer, macro_end, direction, &col)) {
+            return false;
+        }
+        if ((type & DYNAMIC_MACRO_HAS_KEYCODE) && (!dynamic_macro_read(macro_pointer, macro_end, direction, &high) || !dynamic_macro_read(macro_pointer, macro_end, direction, &low))) {
+            return false;
+        }
+        key->type    = type & ~DYNAMIC_MACRO_HAS_KEYCODE;
+        key->row     = row;
+        key->col     = col;
+        key->keycode = (high << 8) | low;
+    }
+
+    *delay = 0;
+    if (header & DYNAMIC_MACRO_HAS_DELAY) {
+        uint8_t data;
+        uint8_t shift = 0;
+        do {
+            if (shift > 14 || !dynamic_macro_read(macro_pointer, macro_end, direction, &data)) {
+                return false;
+            }
+            *delay |= (uint16_t)(data & 0x7F) << shift;
+            shift += 7;
+        } while (data & 0x80);
+    }
+
+    *record = (keyrecord_t){
+        .event =
+            {
+                .key     = MAKE_KEYPOS(key->row, key->col),
+                .type    = key->type,
+                .pressed = header & DYNAMIC_MACRO_PRESSED,
+            },
+    };
+#ifndef NO_ACTION_TAPPING
+    record->tap.interrupted = header & DYNAMIC_MACRO_INTERRUPTED;
+    record->tap.count       = header & DYNAMIC_MACRO_TAP_COUNT;
+#endif
+#if defined(COMBO_ENABLE) || defined(REPEAT_KEY_ENABLE)
+    record->keycode = key->keycode;
+#endif
+
+    return true;
+}
+
 /**
  * Start recording of the dynamic macro.
  *
  * @param[out] macro_pointer The new macro buffer iterator.
  * @param[in]  macro_buffer  The macro buffer used to initialize macro_pointer.
  */
-void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_buffer, int8_t direction) {
+void dynamic_macro_record_start(uint8_t **macro_pointer, uint8_t *macro_buffer, int8_t direction) {
     dprintln("dynamic macro recording: started");
 
     dynamic_macro_record_start_kb(direction);
 
     clear_keyboard();
     layer_clear();
-    *macro_pointer = macro_buffer;
+    *macro_pointer   = macro_buffer;
+    last_release_end = macro_buffer;
+    macro_full       = false;
 }
 
 /**
  * Play the dynamic macro.
  *
+ * The events are decoded one at a time, as they are played.
+ *
  * @param macro_buffer[in] The beginning of the macro buffer being played.
  * @param macro_end[in]    The element after the last macro buffer element.
  * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
  */
-void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
+void dynamic_macro_play(uint8_t *macro_buffer, uint8_t *macro_end, int8_t direction) {
     dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
 
-    layer_state_t saved_layer_state = layer_state;
+    layer_state_t       saved_layer_state = layer_state;
+    dynamic_macro_key_t key               = {0};
 
     clear_keyboard();
     layer_clear();
 
     while (macro_buffer != macro_end) {
-        process_record(macro_buffer);
-        macro_buffer += direction;
+        keyrecord_t record;
+        uint16_t    delay;
+        if (!dynamic_macro_decode(&macro_buffer, macro_end, direction, &key, &record, &delay)) {
+            dprintln("dynamic macro: truncated event, playback stopped");
+            break;
+        }
+#ifdef DYNAMIC_MACRO_TIMING
+        if (delay) {
+            wait_ms(delay);
+        }
+#else
+        (void)delay;
+#endif
+        record.event.time = timer_read();
+        process_record(&record);
 #ifdef DYNAMIC_MACRO_DELAY
         wait_ms(DYNAMIC_MACRO_DELAY);
 #endif
@@ -144,19 +343,33 @@ void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_
  * @param direction[in]  Either +1 or -1, which way to iterate the buffer.
  * @param record[in]     The current keypress.
  */
-void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_pointer, keyrecord_t *macro2_end, int8_t direction, keyrecord_t *record) {
+void dynamic_macro_record_key(uint8_t *macro_buffer, uint8_t **macro_pointer, uint8_t *macro2_end, int8_t direction, keyrecord_t *record) {
     /* If we've just started recording, ignore all the key releases. */
     if (!record->event.pressed && *macro_pointer == macro_buffer) {
         dprintln("dynamic macro: ignoring a leading key-up event");
         return;
     }
 
+    uint8_t data[DYNAMIC_MACRO_MAX_EVENT_SIZE];
+    uint8_t length = dynamic_macro_encode(record, *macro_pointer == macro_buffer, data);
+
     /* The other end of the other macro is the last buffer element it
      * is safe to use before overwriting the other macro.
      */
-    if (*macro_pointer - direction != macro2_end) {
-        **macro_pointer = *record;
-        *macro_pointer += direction;
+    if (!macro_full && DYNAMIC_MACRO_CURRENT_CAPACITY(*macro_pointer, macro2_end) < length) {
+        dprintln("dynamic macro: buffer full, the rest of the recording is dropped");
+        macro_full = true;
+    }
+    if (!macro_full) {
+        for (uint8_t i = 0; i < length; i++) {
+            **macro_pointer = data[i];
+            *macro_pointer += direction;
+        }
+        last_key  = dynamic_macro_key(record);
+        last_time = record->event.time;
+        if (!record->event.pressed) {
+            last_release_end = *macro_pointer;
+        }
     }
     dynamic_macro_record_key_kb(direction, record);
 
@@ -167,15 +380,15 @@ void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_poi
  * End recording of the dynamic macro. Essentially just update the
  * pointer to the end of the macro.
  */
-void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_pointer, int8_t direction, keyrecord_t **macro_end) {
+void dynamic_macro_record_end(uint8_t *macro_buffer, uint8_t *macro_pointer, int8_t direction, uint8_t **macro_end) {
     dynamic_macro_record_end_kb(direction);
 
     /* Do not save the keys being held when stopping the recording,
      * i.e. the keys used to access the layer DM_RSTP is on.
      */
-    while (macro_pointer != macro_buffer && (macro_pointer - direction)->event.pressed) {
-        dprintln("dynamic macro: trimming a trailing key-down event");
-        macro_pointer -= direction;
+    if (macro_pointer != last_release_end) {
+        dprintln("dynamic macro: trimming the trailing key-down events");
+        macro_pointer = last_release_end;
     }
 
     dprintf("dynamic macro: slot %d saved, length: %d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, macro_pointer));
@@ -207,28 +420,78 @@ void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_poin
  * macros or one long macro and one short macro. Or even one empty
  * and one using the whole buffer.
  */
-static keyrecord_t macro_buffer[DYNAMIC_MACRO_SIZE];
+static uint8_t macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE];
 
 /* Pointer to the first buffer element after the first macro.
  * Initially points to the very beginning of the buffer since the
  * macro is empty. */
-static keyrecord_t *macro_end = macro_buffer;
+static uint8_t *macro_end = macro_buffer;
 
 /* The other end of the macro buffer. Serves as the beginning of
  * the second macro. */
-static keyrecord_t *const r_macro_buffer = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
+static uint8_t *const r_macro_buffer = macro_buffer + DYNAMIC_MACRO_BUFFER_SIZE - 1;
 
 /* Like macro_end but for the second macro. */
-static keyrecord_t *r_macro_end = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
+static uint8_t *r_macro_end = macro_buffer + DYNAMIC_MACRO_BUFFER_SIZE - 1;
 
 /* A persistent pointer to the current macro position (iterator)
  * used during the recording. */
-static keyrecord_t *macro_pointer = NULL;
+static uint8_t *macro_pointer = NULL;
 
 /* 0   - no macro is being recorded right now
  * 1,2 - either macro 1 or 2 is being recorded */
 static uint8_t macro_id = 0;
 
+#ifdef DYNAMIC_MACRO_PERSIST
+/* Changes with the size of the buffer and of the matrix, so that stale
+ * data is reset rather than replayed onto other keys */
+#    define DYNAMIC_MACRO_HEADER ((uint32_t)(MATRIX_ROWS & 0xFF) << 24 | (uint32_t)(MATRIX_COLS & 0xFF) << 16 | 0xD000 | (DYNAMIC_MACRO_BUFFER_SIZE & 0x0FFF))
+
+/**
+ * Write a macro that was just recorded to NVM, with a single block
+ * write for its events.
+ *
+ * The macro is emptied first, so that losing power before its length
+ * is written leaves an empty macro rather than a length that doesn't
+ * match the events.
+ */
+static void dynamic_macro_save(uint8_t id) {
+    if (id == 1) {
+        uint16_t length = macro_end - macro_buffer;
+        nvm_dynamic_macro_update_length(0, 0);
+        nvm_dynamic_macro_update_buffer(0, length, macro_buffer);
+        nvm_dynamic_macro_update_length(0, length);
+    } else {
+        uint16_t length = r_macro_buffer - r_macro_end;
+        nvm_dynamic_macro_update_length(1, 0);
+        nvm_dynamic_macro_update_buffer(r_macro_end + 1 - macro_buffer, length, r_macro_end + 1);
+        nvm_dynamic_macro_update_length(1, length);
+    }
+}
+#endif
+
+/**
+ * Load the macros saved in NVM, if they are kept there.
+ */
+void dynamic_macro_init(void) {
+#ifdef DYNAMIC_MACRO_PERSIST
+    uint16_t length1 = nvm_dynamic_macro_read_length(0);
+    uint16_t length2 = nvm_dynamic_macro_read_length(1);
+
+    if (nvm_dynamic_macro_read_header() != DYNAMIC_MACRO_HEADER || length1 + length2 > DYNAMIC_MACRO_BUFFER_SIZE) {
+        nvm_dynamic_macro_erase();
+        nvm_dynamic_macro_update_length(0, 0);
+        nvm_dynamic_macro_update_length(1, 0);
+        nvm_dynamic_macro_update_header(DYNAMIC_MACRO_HEADER);
+        length1 = length2 = 0;
+    }
+
+    nvm_dynamic_macro_read_buffer(0, DYNAMIC_MACRO_BUFFER_SIZE, macro_buffer);
+    macro_end   = macro_buffer + length1;
+    r_macro_end = r_macro_buffer - length2;
+#endif
+}
+
 /**
  * If a dynamic macro is currently being recorded, stop recording.
  */
@@ -241,6 +504,11 @@ void dynamic_macro_stop_recording(void) {
             dynamic_macro_record_end(r_macro_buffer, macro_pointer, -1, &r_macro_end);
             break;
     }
+#ifdef DYNAMIC_MACRO_PERSIST
+    if (macro_id) {
+        dynamic_macro_save(macro_id);
+    }
+#endif
     macro_id = 0;
 }
 
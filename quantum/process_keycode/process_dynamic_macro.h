@@ -35,6 +35,15 @@
 #    define DYNAMIC_MACRO_SIZE 128
 #endif
 
+/* The key events are encoded into a byte buffer, see
+ * process_dynamic_macro.c. A key press usually takes four bytes and its
+ * release one, so by default the buffer holds about 200 events instead
+ * of 128, in half the memory the full key records used to take or less.
+ */
+#ifndef DYNAMIC_MACRO_BUFFER_SIZE
+#    define DYNAMIC_MACRO_BUFFER_SIZE (DYNAMIC_MACRO_SIZE * 4)
+#endif
+
 void dynamic_macro_led_blink(void);
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record);
 bool dynamic_macro_record_start_kb(int8_t direction);
@@ -48,3 +57,4 @@ bool dynamic_macro_record_end_user(int8_t direction);
 bool dynamic_macro_valid_key_kb(uint16_t keycode, keyrecord_t *record);
 bool dynamic_macro_valid_key_user(uint16_t keycode, keyrecord_t *record);
 void dynamic_macro_stop_recording(void);
+void dynamic_macro_init(void);
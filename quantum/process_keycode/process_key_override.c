@@ -243,14 +243,150 @@ static bool check_activation_event(const key_override_t *override, const bool ke
     }
 }
 
+#ifdef KEY_OVERRIDE_TRIGGER_INDEX
+// Override indices sorted by trigger, then by index. The overrides without a trigger key (KC_NO) come first.
+static uint8_t  trigger_index[KEY_OVERRIDE_TRIGGER_INDEX_SIZE];
+static uint8_t  trigger_index_size  = 0;
+static uint16_t trigger_index_count = UINT16_MAX;
+static bool     trigger_index_fits  = false;
+
+void key_override_trigger_index_invalidate(void) {
+    trigger_index_count = UINT16_MAX;
+}
+
+static inline uint16_t trigger_index_trigger(const uint8_t position) {
+    return key_override_get(trigger_index[position])->trigger;
+}
+
+static void trigger_index_build(void) {
+    trigger_index_count = key_override_count();
+    trigger_index_size  = 0;
+    trigger_index_fits  = true;
+
+    // Insertion sort, this only runs when the overrides change
+    for (uint16_t i = 0; i < trigger_index_count; i++) {
+        const key_override_t *const override = key_override_get(i);
+
+        // End of array
+        if (override == NULL) {
+            break;
+        }
+
+        if (i >= KEY_OVERRIDE_TRIGGER_INDEX_SIZE) {
+            key_override_printf("Too many overrides for the trigger index, checking all of them\n");
+            trigger_index_fits = false;
+            return;
+        }
+
+        uint8_t position = trigger_index_size++;
+        for (; position > 0 && trigger_index_trigger(position - 1) > override->trigger; position--) {
+            trigger_index[position] = trigger_index[position - 1];
+        }
+        trigger_index[position] = i;
+    }
+}
+
+// Returns the position of the first override with the provided trigger, or trigger_index_size if there is none
+static uint8_t trigger_index_find(const uint16_t trigger) {
+    uint8_t low = 0, high = trigger_index_size;
+    while (low < high) {
+        uint8_t mid = low + (high - low) / 2;
+        if (trigger_index_trigger(mid) < trigger) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < trigger_index_size && trigger_index_trigger(low) == trigger) ? low : trigger_index_size;
+}
+#endif
+
+typedef struct {
+    uint8_t next;
+#ifdef KEY_OVERRIDE_TRIGGER_INDEX
+    // When indexed, the runs of overrides for each trigger that can activate, merged back into array order
+    bool     indexed;
+    uint8_t  run_count;
+    uint8_t  run_position[3];
+    uint16_t run_trigger[3];
+#endif
+} override_candidates_t;
+
+#ifdef KEY_OVERRIDE_TRIGGER_INDEX
+static void add_candidate_run(override_candidates_t *candidates, const uint16_t trigger) {
+    const uint8_t position = trigger_index_find(trigger);
+    if (position < trigger_index_size) {
+        candidates->run_position[candidates->run_count] = position;
+        candidates->run_trigger[candidates->run_count]  = trigger;
+        candidates->run_count++;
+    }
+}
+#endif
+
+/** Sets up the iteration over the overrides that could activate on an event for `keycode`. */
+static void start_candidates(override_candidates_t *candidates, const uint16_t keycode) {
+    candidates->next = 0;
+#ifdef KEY_OVERRIDE_TRIGGER_INDEX
+    if (trigger_index_count != key_override_count()) {
+        trigger_index_build();
+    }
+
+    candidates->indexed   = trigger_index_fits;
+    candidates->run_count = 0;
+    if (!candidates->indexed) {
+        return;
+    }
+
+    // Only the overrides without a trigger key, triggered by this key, or by the last non-mod key that was pressed down can activate
+    add_candidate_run(candidates, KC_NO);
+    if (keycode != KC_NO) {
+        add_candidate_run(candidates, keycode);
+    }
+    if (last_key_down != KC_NO && last_key_down != keycode) {
+        add_candidate_run(candidates, last_key_down);
+    }
+#endif
+}
+
+/** Returns the next override to check, in array order, or NULL if there are no more. */
+static const key_override_t *next_candidate(override_candidates_t *candidates) {
+#ifdef KEY_OVERRIDE_TRIGGER_INDEX
+    if (candidates->indexed) {
+        uint8_t best = candidates->run_count;
+        for (uint8_t run = 0; run < candidates->run_count; run++) {
+            const uint8_t position = candidates->run_position[run];
+            if (position >= trigger_index_size || trigger_index_trigger(position) != candidates->run_trigger[run]) {
+                continue;
+            }
+            if (best == candidates->run_count || trigger_index[position] < trigger_index[candidates->run_position[best]]) {
+                best = run;
+            }
+        }
+
+        if (best == candidates->run_count) {
+            return NULL;
+        }
+        return key_override_get(trigger_index[candidates->run_position[best]++]);
+    }
+#endif
+
+    if (candidates->next >= key_override_count()) {
+        return NULL;
+    }
+    return key_override_get(candidates->next++);
+}
+
 /** Iterates through the list of key overrides and tries activating each, until it finds one that activates or reaches the end of overrides. Returns true if the key action for `keycode` should be sent */
 static bool try_activating_override(const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *activated) {
     if (key_override_count() == 0) {
         return true;
     }
 
-    for (uint8_t i = 0; i < key_override_count(); i++) {
-        const key_override_t *const override = key_override_get(i);
+    override_candidates_t candidates;
+    start_candidates(&candidates, keycode);
+
+    while (true) {
+        const key_override_t *const override = next_candidate(&candidates);
 
         // End of array
         if (override == NULL) {
@@ -22,6 +22,14 @@
 #include "action.h"
 #include "action_layer.h"
 
+#ifndef KEY_OVERRIDE_TRIGGER_INDEX_SIZE
+#    define KEY_OVERRIDE_TRIGGER_INDEX_SIZE 64
+#endif
+
+#if KEY_OVERRIDE_TRIGGER_INDEX_SIZE > 255
+#    error "KEY_OVERRIDE_TRIGGER_INDEX_SIZE must be at most 255"
+#endif
+
 /**
  * Key overrides allow you to send a different key-modifier combination or perform a custom action when a certain modifier-key combination is pressed.
  *
@@ -105,6 +113,13 @@ bool process_key_override(const uint16_t keycode, const keyrecord_t *const recor
 /** Perform any deferred keys */
 void key_override_task(void);
 
+#ifdef KEY_OVERRIDE_TRIGGER_INDEX
+/** Rebuild the trigger index on the next key event, after the triggers of the overrides changed */
+void key_override_trigger_index_invalidate(void);
+#else
+#    define key_override_trigger_index_invalidate()
+#endif
+
 /**
  *  Preferrably use these macros to create key overrides. They fix many of the options to a standard setting that should satisfy most basic use-cases. Only directly create a key_override_t struct when you really need to.
  */
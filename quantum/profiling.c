@@ -0,0 +1,303 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "profiling.h"
+#include "timer.h"
+#include "util.h"
+#include "debug.h"
+#include "print.h"
+
+#ifdef RAW_ENABLE
+#    include "raw_hid.h"
+#endif
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#    include <hal.h>
+#elif defined(__AVR__)
+#    include <avr/io.h>
+#    include <util/atomic.h>
+#    include "timer_avr.h"
+#else
+#    include <time.h>
+#endif
+
+#ifndef PROFILING_CONSOLE_INTERVAL
+#    define PROFILING_CONSOLE_INTERVAL 5000
+#endif
+
+#define PROFILING_PACKET_SIZE 32
+
+static const char *const builtin_names[PROFILING_SECTION_USER] = {
+    [PROFILING_SECTION_KEYBOARD_TASK]        = "keyboard_task",
+    [PROFILING_SECTION_MATRIX_TASK]          = "matrix_task",
+    [PROFILING_SECTION_QUANTUM_TASK]         = "quantum_task",
+    [PROFILING_SECTION_RGB_MATRIX_TASK]      = "rgb_matrix_task",
+    [PROFILING_SECTION_OLED_TASK]            = "oled_task",
+    [PROFILING_SECTION_POINTING_DEVICE_TASK] = "pointing_device_task",
+    [PROFILING_SECTION_SPLIT_TRANSACTIONS]   = "split_transactions",
+};
+
+static const char       *user_names[PROFILING_MAX_USER_SECTIONS];
+static uint8_t           user_section_count = 0;
+static profiling_stats_t stats[PROFILING_SECTION_COUNT];
+
+// cycle counters
+
+#if defined(PROTOCOL_CHIBIOS) && defined(DWT)
+static void profiling_init_ticks(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t profiling_read_ticks(void) {
+    return DWT->CYCCNT;
+}
+#elif defined(PROTOCOL_CHIBIOS)
+// Cortex-M0/M0+ have no DWT cycle counter, fall back to what the port provides
+static void profiling_init_ticks(void) {}
+
+uint32_t profiling_read_ticks(void) {
+#    if PORT_SUPPORTS_RT == TRUE
+    return chSysGetRealtimeCounterX();
+#    else
+    return chVTGetSystemTimeX();
+#    endif
+}
+#elif defined(__AVR__)
+extern volatile uint32_t timer_count;
+
+static void profiling_init_ticks(void) {}
+
+uint32_t profiling_read_ticks(void) {
+    uint32_t ms;
+    uint8_t  raw;
+    bool     pending;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms  = timer_count;
+        raw = TIMER_RAW;
+#    if defined(__AVR_ATmega32A__)
+        pending = TIFR & _BV(OCF0);
+#    elif defined(__AVR_ATtiny85__)
+        pending = TIFR & _BV(OCF0A);
+#    else
+        pending = TIFR0 & _BV(OCF0A);
+#    endif
+    }
+
+    // Timer0 wrapped but its interrupt hasn't run yet
+    if (pending && raw < (TIMER_RAW_TOP / 2)) {
+        ms++;
+    }
+
+    return (ms * (TIMER_RAW_TOP + 1) + raw) * TIMER_PRESCALER;
+}
+#else
+static void profiling_init_ticks(void) {}
+
+uint32_t profiling_read_ticks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+#endif
+
+// registry
+
+static inline bool section_is_valid(uint8_t section) {
+    return section < PROFILING_SECTION_USER + user_section_count;
+}
+
+static void reset_stats(profiling_stats_t *s) {
+    uint32_t start = s->start;
+    memset(s, 0, sizeof(profiling_stats_t));
+    s->min   = UINT32_MAX;
+    s->start = start;
+}
+
+void profiling_init(void) {
+    profiling_init_ticks();
+    profiling_reset();
+}
+
+void profiling_reset(void) {
+    for (uint8_t i = 0; i < PROFILING_SECTION_COUNT; i++) {
+        reset_stats(&stats[i]);
+    }
+}
+
+uint8_t profiling_register_section(const char *name) {
+    if (user_section_count >= PROFILING_MAX_USER_SECTIONS) {
+        return PROFILING_SECTION_INVALID;
+    }
+    user_names[user_section_count] = name;
+    return PROFILING_SECTION_USER + user_section_count++;
+}
+
+void profiling_start(uint8_t section) {
+    if (!section_is_valid(section)) {
+        return;
+    }
+    stats[section].start = profiling_read_ticks();
+}
+
+void profiling_stop(uint8_t section) {
+    if (!section_is_valid(section)) {
+        return;
+    }
+    profiling_record(section, profiling_read_ticks() - stats[section].start);
+}
+
+void profiling_record(uint8_t section, uint32_t ticks) {
+    if (!section_is_valid(section)) {
+        return;
+    }
+
+    profiling_stats_t *s = &stats[section];
+    if (s->count == UINT32_MAX) {
+        return;
+    }
+
+    s->count++;
+    s->total += ticks;
+    if (ticks < s->min) s->min = ticks;
+    if (ticks > s->max) s->max = ticks;
+
+    // log4 buckets: [0,4), [4,16), [16,64), ...
+    uint8_t bucket = 0;
+    while (bucket < (PROFILING_HISTOGRAM_BUCKETS - 1) && (ticks >>= 2)) {
+        bucket++;
+    }
+    if (s->histogram[bucket] < UINT16_MAX) {
+        s->histogram[bucket]++;
+    }
+}
+
+const profiling_stats_t *profiling_get_stats(uint8_t section) {
+    return section_is_valid(section) ? &stats[section] : NULL;
+}
+
+const char *profiling_get_name(uint8_t section) {
+    if (!section_is_valid(section)) {
+        return NULL;
+    }
+    if (section < PROFILING_SECTION_USER) {
+        return builtin_names[section];
+    }
+    return user_names[section - PROFILING_SECTION_USER];
+}
+
+uint32_t profiling_get_mean(uint8_t section) {
+    if (!section_is_valid(section) || stats[section].count == 0) {
+        return 0;
+    }
+    return (uint32_t)(stats[section].total / stats[section].count);
+}
+
+// serialisation
+
+static inline void pack_u32(uint8_t *dest, uint32_t value) {
+    dest[0] = value & 0xFF;
+    dest[1] = (value >> 8) & 0xFF;
+    dest[2] = (value >> 16) & 0xFF;
+    dest[3] = (value >> 24) & 0xFF;
+}
+
+static void pack_stats(uint8_t *data, uint8_t section) {
+    // [ cmd, sub, section, count, min, max, mean, name... ]
+    const profiling_stats_t *s = &stats[section];
+    pack_u32(&data[3], s->count);
+    pack_u32(&data[7], s->count ? s->min : 0);
+    pack_u32(&data[11], s->max);
+    pack_u32(&data[15], profiling_get_mean(section));
+
+    const char *name = profiling_get_name(section);
+    strncpy((char *)&data[19], name ? name : "", PROFILING_PACKET_SIZE - 19);
+}
+
+#ifdef RAW_ENABLE
+static void pack_histogram(uint8_t *data, uint8_t section, uint8_t offset) {
+    // [ cmd, sub, section, offset, count, buckets... ]
+    uint8_t count = 0;
+    for (uint8_t i = offset; i < PROFILING_HISTOGRAM_BUCKETS && (5 + (count + 1) * 2) <= PROFILING_PACKET_SIZE; i++, count++) {
+        data[5 + count * 2]     = stats[section].histogram[i] & 0xFF;
+        data[5 + count * 2 + 1] = stats[section].histogram[i] >> 8;
+    }
+    data[3] = offset;
+    data[4] = count;
+}
+
+bool profiling_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < PROFILING_PACKET_SIZE || data[0] != PROFILING_RAW_HID_COMMAND) {
+        return false;
+    }
+
+    uint8_t section = data[2];
+    uint8_t offset  = data[3];
+    memset(&data[3], 0, length - 3);
+    switch (data[1]) {
+        case PROFILING_CMD_GET_INFO:
+            data[2] = PROFILING_SECTION_USER + user_section_count;
+            data[3] = PROFILING_HISTOGRAM_BUCKETS;
+            break;
+        case PROFILING_CMD_GET_STATS:
+            if (section_is_valid(section)) {
+                pack_stats(data, section);
+            } else {
+                data[2] = PROFILING_SECTION_INVALID;
+            }
+            break;
+        case PROFILING_CMD_GET_HISTOGRAM:
+            if (section_is_valid(section)) {
+                pack_histogram(data, section, offset);
+            } else {
+                data[2] = PROFILING_SECTION_INVALID;
+            }
+            break;
+        case PROFILING_CMD_RESET:
+            profiling_reset();
+            break;
+        default:
+            data[1] = 0xFF;
+            break;
+    }
+
+    raw_hid_send(data, length);
+    return true;
+}
+#endif
+
+// console
+
+static void print_packet(const uint8_t *data) {
+    dprint("prof:");
+    for (uint8_t i = 0; i < PROFILING_PACKET_SIZE; i++) {
+        dprintf("%02X", data[i]);
+    }
+    dprint("\n");
+}
+
+void profiling_print(void) {
+    uint8_t data[PROFILING_PACKET_SIZE];
+    for (uint8_t section = 0; section < PROFILING_SECTION_USER + user_section_count; section++) {
+        memset(data, 0, sizeof(data));
+        data[0] = PROFILING_RAW_HID_COMMAND;
+        data[1] = PROFILING_CMD_GET_STATS;
+        data[2] = section;
+        pack_stats(data, section);
+        print_packet(data);
+    }
+}
+
+void profiling_task(void) {
+#if PROFILING_CONSOLE_INTERVAL > 0
+    static uint32_t last_print = 0;
+    if (timer_elapsed32(last_print) >= PROFILING_CONSOLE_INTERVAL) {
+        last_print = timer_read32();
+        profiling_print();
+    }
+#endif
+}
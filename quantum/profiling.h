@@ -0,0 +1,159 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup profiling Profiling API
+ *
+ * \brief Registry of named code sections with cycle count statistics.
+ *
+ * Each section keeps its call count, min/max/mean duration and a log4
+ * histogram of durations. Durations are measured in CPU cycles on AVR and
+ * Cortex-M, and in nanoseconds on the test platform.
+ *
+ * Usage example:
+ *
+ *     static uint8_t my_section = PROFILING_SECTION_INVALID;
+ *
+ *     void keyboard_post_init_user(void) {
+ *         my_section = profiling_register_section("my_section");
+ *     }
+ *
+ *     void housekeeping_task_user(void) {
+ *         PROFILING_START(my_section);
+ *         do_work();
+ *         PROFILING_STOP(my_section);
+ *     }
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef PROFILING_MAX_USER_SECTIONS
+#    define PROFILING_MAX_USER_SECTIONS 4
+#endif
+
+#ifndef PROFILING_HISTOGRAM_BUCKETS
+#    define PROFILING_HISTOGRAM_BUCKETS 16
+#endif
+
+#ifndef PROFILING_RAW_HID_COMMAND
+#    define PROFILING_RAW_HID_COMMAND 0xE0
+#endif
+
+/** \brief Built-in profiling sections
+ */
+enum profiling_section {
+    PROFILING_SECTION_KEYBOARD_TASK,
+    PROFILING_SECTION_MATRIX_TASK,
+    PROFILING_SECTION_QUANTUM_TASK,
+    PROFILING_SECTION_RGB_MATRIX_TASK,
+    PROFILING_SECTION_OLED_TASK,
+    PROFILING_SECTION_POINTING_DEVICE_TASK,
+    PROFILING_SECTION_SPLIT_TRANSACTIONS,
+    PROFILING_SECTION_USER,
+    PROFILING_SECTION_COUNT = PROFILING_SECTION_USER + PROFILING_MAX_USER_SECTIONS,
+    PROFILING_SECTION_INVALID = 0xFF,
+};
+
+/** \brief Raw HID sub-commands, sent after `PROFILING_RAW_HID_COMMAND`
+ */
+enum profiling_raw_hid_command {
+    PROFILING_CMD_GET_INFO      = 0x01,
+    PROFILING_CMD_GET_STATS     = 0x02,
+    PROFILING_CMD_GET_HISTOGRAM = 0x03,
+    PROFILING_CMD_RESET         = 0x04,
+};
+
+/** \brief Statistics collected for a single section
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t start;
+    uint16_t histogram[PROFILING_HISTOGRAM_BUCKETS];
+} profiling_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Initialise the cycle counter and clear all statistics
+ */
+void profiling_init(void);
+
+/** \brief Read the free running cycle counter
+ */
+uint32_t profiling_read_ticks(void);
+
+/** \brief Register a named user section
+ *
+ * \param name Section name, must outlive the registry
+ * \return section id, or `PROFILING_SECTION_INVALID` if the registry is full
+ */
+uint8_t profiling_register_section(const char *name);
+
+/** \brief Mark the start of a section
+ */
+void profiling_start(uint8_t section);
+
+/** \brief Mark the end of a section and record its duration
+ */
+void profiling_stop(uint8_t section);
+
+/** \brief Record an externally measured duration against a section
+ */
+void profiling_record(uint8_t section, uint32_t ticks);
+
+/** \brief Clear the statistics of every section
+ */
+void profiling_reset(void);
+
+/** \brief Access the statistics of a section
+ *
+ * \return pointer to the statistics, or NULL for unknown sections
+ */
+const profiling_stats_t *profiling_get_stats(uint8_t section);
+
+/** \brief Get the name of a section
+ */
+const char *profiling_get_name(uint8_t section);
+
+/** \brief Mean duration of a section
+ */
+uint32_t profiling_get_mean(uint8_t section);
+
+/** \brief Handle a profiling raw HID packet
+ *
+ * \return true if the packet was a profiling command and has been answered
+ */
+bool profiling_raw_hid_receive(uint8_t *data, uint8_t length);
+
+/** \brief Dump every section over the console, in the raw HID packet format
+ */
+void profiling_print(void);
+
+/** \brief Periodically dump statistics over the console
+ */
+void profiling_task(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef PROFILING_ENABLE
+#    define PROFILING_START(section) profiling_start(section)
+#    define PROFILING_STOP(section) profiling_stop(section)
+#else
+#    define PROFILING_START(section)
+#    define PROFILING_STOP(section)
+#endif
+
+/** \} */
@@ -16,6 +16,7 @@
 
 #include "quantum.h"
 #include "process_quantum.h"
+#include "latency_tracer.h"
 
 #ifdef SLEEP_LED_ENABLE
 #    include "sleep_led.h"
@@ -254,9 +255,35 @@ uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) {
         return record->keycode;
     }
 #endif
+#ifdef RECORD_KEYCODE_CACHE
+    /* A keycode resolved without updating the source layers cache may come from a stale
+     * source layer, so it can't answer a lookup that would have updated it. Releases
+     * always read the source layers cache, so the distinction only matters for presses.
+     */
+    if (record->keycode_cache.valid && record->keycode_cache.pressed == record->event.pressed && record->keycode_cache.layer_generation == layer_state_generation && (record->keycode_cache.updated || !update_layer_cache)) {
+        return record->keycode_cache.keycode;
+    }
+
+    record->keycode_cache.keycode          = get_event_keycode(record->event, update_layer_cache);
+    record->keycode_cache.layer_generation = layer_state_generation;
+    record->keycode_cache.pressed          = record->event.pressed;
+    record->keycode_cache.updated          = update_layer_cache || !record->event.pressed;
+    record->keycode_cache.valid            = true;
+    return record->keycode_cache.keycode;
+#else
     return get_event_keycode(record->event, update_layer_cache);
+#endif
 }
 
+#ifdef RECORD_KEYCODE_CACHE
+/* Forget the keycode of a record, for when its lookup may resolve differently
+ * without the layer state having been set, such as a keymap change.
+ */
+void clear_record_keycode_cache(keyrecord_t *record) {
+    record->keycode_cache.valid = false;
+}
+#endif
+
 /* Convert event into usable keycode. Checks the layer cache to ensure that it
  * retains the correct keycode after a layer change, if the key is still pressed.
  * "update_layer_cache" is to ensure that it only updates the layer cache when
@@ -301,6 +328,13 @@ void post_process_record_quantum(keyrecord_t *record) {
  *
  * Hands off handling to other quantum/process_keycode/ functions
  */
+/* Handlers in process_record_quantum() that only consume their own keycodes
+ * are guarded by the range of those keycodes, so that a plain keycode only
+ * reaches the handlers that need to observe every event. Those are called
+ * unconditionally, in the same chain, to keep the order between the two.
+ */
+#define PROCESS_IF(consumes, handler) (!(consumes) || handler(keycode, record))
+
 bool process_record_quantum(keyrecord_t *record) {
     uint16_t keycode = get_record_keycode(record, true);
 
@@ -322,10 +356,14 @@ bool process_record_quantum(keyrecord_t *record) {
     if (preprocess_tap_dance(keycode, record)) {
         // The tap dance might have updated the layer state, therefore the
         // result of the keycode lookup might change.
+        clear_record_keycode_cache(record);
         keycode = get_record_keycode(record, true);
     }
 #endif
 
+    // After tap dance, so that a dance finished by this key is still attributed to the dance
+    latency_tracer_process_record(record->event, keycode);
+
 #ifdef RGBLIGHT_ENABLE
     if (record->event.pressed) {
         preprocess_rgblight();
@@ -362,28 +400,28 @@ bool process_record_quantum(keyrecord_t *record) {
             process_record_modules(keycode, record) && // modules must run before kb
             process_record_kb(keycode, record) &&
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+            PROCESS_IF(IS_QK_MACRO(keycode), process_record_via) &&
 #endif
 #if defined(SECURE_ENABLE)
             process_secure(keycode, record) &&
 #endif
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+            PROCESS_IF(IS_QK_SEQUENCER(keycode), process_sequencer) &&
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+            PROCESS_IF(IS_QK_MIDI(keycode), process_midi) &&
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+            PROCESS_IF(IS_QK_AUDIO(keycode), process_audio) &&
 #endif
 #if defined(BACKLIGHT_ENABLE)
-            process_backlight(keycode, record) &&
+            PROCESS_IF(IS_QK_LIGHTING(keycode), process_backlight) &&
 #endif
 #if defined(LED_MATRIX_ENABLE)
-            process_led_matrix(keycode, record) &&
+            PROCESS_IF(IS_QK_LIGHTING(keycode), process_led_matrix) &&
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+            PROCESS_IF(IS_QK_STENO(keycode), process_steno) &&
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
             process_music(keycode, record) &&
@@ -395,7 +433,7 @@ bool process_record_quantum(keyrecord_t *record) {
             process_key_override(keycode, record) &&
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+            PROCESS_IF(IS_QK_TAP_DANCE(keycode), process_tap_dance) &&
 #endif
 #if defined(UNICODE_COMMON_ENABLE)
             process_unicode_common(keycode, record) &&
@@ -407,46 +445,46 @@ bool process_record_quantum(keyrecord_t *record) {
             process_auto_shift(keycode, record) &&
 #endif
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
-            process_dynamic_tapping_term(keycode, record) &&
+            PROCESS_IF(IS_QK_QUANTUM(keycode), process_dynamic_tapping_term) &&
 #endif
 #ifdef SPACE_CADET_ENABLE
             process_space_cadet(keycode, record) &&
 #endif
 #ifdef MAGIC_ENABLE
-            process_magic(keycode, record) &&
+            PROCESS_IF(IS_QK_MAGIC(keycode), process_magic) &&
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+            PROCESS_IF(IS_QK_QUANTUM(keycode), process_grave_esc) &&
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_underglow(keycode, record) &&
+            PROCESS_IF(IS_QK_LIGHTING(keycode) || IS_QK_QUANTUM(keycode), process_underglow) &&
 #endif
 #if defined(RGB_MATRIX_ENABLE)
-            process_rgb_matrix(keycode, record) &&
+            PROCESS_IF(IS_QK_LIGHTING(keycode), process_rgb_matrix) &&
 #endif
 #ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
+            PROCESS_IF(IS_QK_JOYSTICK(keycode), process_joystick) &&
 #endif
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-            process_programmable_button(keycode, record) &&
+            PROCESS_IF(IS_QK_PROGRAMMABLE_BUTTON(keycode), process_programmable_button) &&
 #endif
 #ifdef AUTOCORRECT_ENABLE
             process_autocorrect(keycode, record) &&
 #endif
 #ifdef TRI_LAYER_ENABLE
-            process_tri_layer(keycode, record) &&
+            PROCESS_IF(IS_QK_QUANTUM(keycode), process_tri_layer) &&
 #endif
 #if !defined(NO_ACTION_LAYER)
-            process_default_layer(keycode, record) &&
+            PROCESS_IF(IS_QK_PERSISTENT_DEF_LAYER(keycode), process_default_layer) &&
 #endif
 #ifdef LAYER_LOCK_ENABLE
             process_layer_lock(keycode, record) &&
 #endif
 #ifdef CONNECTION_ENABLE
-            process_connection(keycode, record) &&
+            PROCESS_IF(IS_QK_CONNECTION(keycode), process_connection) &&
 #endif
 #ifndef NO_ACTION_ONESHOT
-            process_oneshot(keycode, record) &&
+            PROCESS_IF(IS_QK_QUANTUM(keycode), process_oneshot) &&
 #endif
             process_quantum(keycode, record))) {
         return false;
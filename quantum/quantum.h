@@ -71,6 +71,10 @@
 #    include "deferred_exec.h"
 #endif
 
+#ifdef MATRIX_INTERRUPT_ENABLE
+#    include "matrix_interrupt.h"
+#endif
+
 extern layer_state_t default_layer_state;
 
 #ifndef NO_ACTION_LAYER
@@ -24,6 +24,17 @@
 #include "action.h"
 #include "wait.h"
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+#    include <string.h>
+#    include "deferred_exec.h"
+#    include "timer.h"
+#endif
+
+#ifdef SEND_STRING_PACKED
+#    include "action_util.h"
+#    include "report.h"
+#endif
+
 #if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
 #    include "audio.h"
 #    ifndef BELL_SOUND
@@ -150,11 +161,130 @@ void send_string(const char *string) {
     send_string_with_delay(string, TAP_CODE_DELAY);
 }
 
+#ifdef SEND_STRING_PACKED
+#    ifndef SEND_STRING_PACKED_KEYS
+#        define SEND_STRING_PACKED_KEYS KEYBOARD_REPORT_KEYS
+#    endif
+#    ifndef SEND_STRING_PACKED_INTERVAL
+#        define SEND_STRING_PACKED_INTERVAL KEYBOARD_REPORT_POLL_INTERVAL
+#    endif
+
+// Characters typed together in one report: distinct keys sharing the same modifiers
+typedef struct send_string_batch_t {
+    uint8_t keys[SEND_STRING_PACKED_KEYS];
+    uint8_t count;
+    uint8_t capacity;
+    bool    is_shifted;
+    bool    is_altgred;
+} send_string_batch_t;
+
+static uint8_t send_string_batch_capacity(void) {
+    uint8_t free = get_keyboard_report_free_keys();
+    return free < SEND_STRING_PACKED_KEYS ? free : SEND_STRING_PACKED_KEYS;
+}
+
+static void send_string_batch_flush(send_string_batch_t *batch, uint8_t interval) {
+    if (!batch->count) {
+        return;
+    }
+
+    // Every report has to be polled by the host to be seen
+    const uint8_t pace = interval > SEND_STRING_PACKED_INTERVAL ? interval : SEND_STRING_PACKED_INTERVAL;
+
+    if (batch->is_shifted) {
+        register_code(KC_LEFT_SHIFT);
+        wait_ms(pace);
+    }
+
+    if (batch->is_altgred) {
+        register_code(KC_RIGHT_ALT);
+        wait_ms(pace);
+    }
+
+    for (uint8_t i = 0; i < batch->count; i++) {
+        add_key(batch->keys[i]);
+    }
+    send_keyboard_report();
+    wait_ms(pace);
+
+    for (uint8_t i = 0; i < batch->count; i++) {
+        del_key(batch->keys[i]);
+    }
+    send_keyboard_report();
+    wait_ms(pace);
+
+    if (batch->is_altgred) {
+        unregister_code(KC_RIGHT_ALT);
+        wait_ms(pace);
+    }
+
+    if (batch->is_shifted) {
+        unregister_code(KC_LEFT_SHIFT);
+        wait_ms(pace);
+    }
+
+    batch->count = 0;
+}
+
+/**
+ * Adds the character to the batch, sending the batch first if the character can't go in the same report.
+ * Returns false, with the batch sent, if the character has to be sent on its own.
+ */
+static bool send_string_batch_add(send_string_batch_t *batch, char ascii_code, uint8_t interval) {
+#    if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+    if (ascii_code == '\a') {
+        send_string_batch_flush(batch, interval);
+        return false;
+    }
+#    endif
+
+    uint8_t keycode    = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+    bool    is_shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code);
+    bool    is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code);
+    bool    is_dead    = PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code);
+
+    if (keycode == KC_NO || is_dead || is_key_pressed(keycode)) {
+        send_string_batch_flush(batch, interval);
+        return false;
+    }
+
+    bool fits = batch->count < batch->capacity && batch->is_shifted == is_shifted && batch->is_altgred == is_altgred;
+    for (uint8_t i = 0; fits && i < batch->count; i++) {
+        // A repeated key needs a release in between
+        fits = batch->keys[i] != keycode;
+    }
+    if (fits && batch->count) {
+        // Keys in a report have no order, hosts may see them in keycode order
+        fits = batch->keys[batch->count - 1] < keycode;
+    }
+
+    if (!fits || !batch->count) {
+        send_string_batch_flush(batch, interval);
+        batch->capacity   = send_string_batch_capacity();
+        batch->is_shifted = is_shifted;
+        batch->is_altgred = is_altgred;
+        if (!batch->capacity) {
+            return false;
+        }
+    }
+
+    batch->keys[batch->count++] = keycode;
+    return true;
+}
+#endif
+
 void send_string_with_delay_impl(char (*getter)(void *), void *arg, uint8_t interval) {
+#ifdef SEND_STRING_PACKED
+    send_string_batch_t batch = {0};
+#endif
+
     while (1) {
         char ascii_code = getter(arg);
         if (!ascii_code) break;
         if (ascii_code == SS_QMK_PREFIX) {
+#ifdef SEND_STRING_PACKED
+            send_string_batch_flush(&batch, interval);
+#endif
             ascii_code = getter(arg);
 
             if (ascii_code == SS_TAP_CODE) {
@@ -188,9 +318,18 @@ void send_string_with_delay_impl(char (*getter)(void *), void *arg, uint8_t inte
             // if we had a delay that terminated with a null, we're done
             if (ascii_code == 0) break;
         } else {
+#ifdef SEND_STRING_PACKED
+            if (send_string_batch_add(&batch, ascii_code, interval)) {
+                continue;
+            }
+#endif
             send_char_with_delay(ascii_code, interval);
         }
     }
+
+#ifdef SEND_STRING_PACKED
+    send_string_batch_flush(&batch, interval);
+#endif
 }
 
 typedef struct send_string_memory_state_t {
@@ -326,3 +465,237 @@ void send_string_with_delay_P(const char *string, uint8_t interval) {
     send_string_with_delay_impl(send_string_get_next_progmem, &state, interval);
 }
 #endif
+
+#ifdef SEND_STRING_ASYNC_ENABLE
+typedef struct send_string_async_entry_t {
+    char (*getter)(void *);
+    uint32_t                     arg[2]; // copy of the getter's state
+    uint8_t                      interval;
+    bool                         ended;
+    send_string_async_callback_t callback;
+    void *                       cb_arg;
+} send_string_async_entry_t;
+
+static send_string_async_entry_t send_string_async_queue[SEND_STRING_ASYNC_QUEUE_SIZE];
+static uint8_t                   send_string_async_head  = 0;
+static uint8_t                   send_string_async_count = 0;
+
+// The key presses and releases left to send for the current character
+#    define SEND_STRING_ASYNC_PRESS 0x100
+static uint16_t send_string_async_keys[8];
+static uint8_t  send_string_async_key_count = 0;
+static uint8_t  send_string_async_key_index = 0;
+
+static deferred_executor_t send_string_async_executor[1] = {0};
+static uint32_t            send_string_async_last_exec   = 0;
+static deferred_token      send_string_async_token       = INVALID_DEFERRED_TOKEN;
+
+static inline void send_string_async_add_key(uint8_t keycode, bool pressed) {
+    send_string_async_keys[send_string_async_key_count++] = keycode | (pressed ? SEND_STRING_ASYNC_PRESS : 0);
+}
+
+static void send_string_async_add_tap(uint8_t keycode) {
+    send_string_async_add_key(keycode, true);
+    send_string_async_add_key(keycode, false);
+}
+
+// Same key events as send_char_with_delay()
+static void send_string_async_add_char(char ascii_code) {
+#    if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+    if (ascii_code == '\a') { // BEL
+        PLAY_SONG(bell_song);
+        return;
+    }
+#    endif
+
+    uint8_t keycode    = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+    bool    is_shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code);
+    bool    is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code);
+    bool    is_dead    = PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code);
+
+    if (is_shifted) {
+        send_string_async_add_key(KC_LEFT_SHIFT, true);
+    }
+    if (is_altgred) {
+        send_string_async_add_key(KC_RIGHT_ALT, true);
+    }
+    send_string_async_add_tap(keycode);
+    if (is_altgred) {
+        send_string_async_add_key(KC_RIGHT_ALT, false);
+    }
+    if (is_shifted) {
+        send_string_async_add_key(KC_LEFT_SHIFT, false);
+    }
+    if (is_dead) {
+        send_string_async_add_tap(KC_SPACE);
+    }
+}
+
+// Reads the next character or code of the string, returns the time to wait before reading on
+static uint32_t send_string_async_read(send_string_async_entry_t *entry) {
+    char ascii_code = entry->getter(entry->arg);
+    if (!ascii_code) {
+        entry->ended = true;
+        return 0;
+    }
+
+    if (ascii_code != SS_QMK_PREFIX) {
+        send_string_async_add_char(ascii_code);
+        return 0;
+    }
+
+    ascii_code = entry->getter(entry->arg);
+    if (ascii_code == SS_TAP_CODE) {
+        send_string_async_add_tap(entry->getter(entry->arg));
+    } else if (ascii_code == SS_DOWN_CODE) {
+        send_string_async_add_key(entry->getter(entry->arg), true);
+    } else if (ascii_code == SS_UP_CODE) {
+        send_string_async_add_key(entry->getter(entry->arg), false);
+    } else if (ascii_code == SS_DELAY_CODE) {
+        uint32_t ms = 0;
+        ascii_code  = entry->getter(entry->arg);
+
+        while (isdigit(ascii_code)) {
+            ms *= 10;
+            ms += ascii_code - '0';
+            ascii_code = entry->getter(entry->arg);
+        }
+
+        // The getter may not be called again once it returned the end of the string
+        entry->ended = ascii_code == 0;
+        return ms + entry->interval;
+    } else if (ascii_code == 0) {
+        entry->ended = true;
+    }
+    return 0;
+}
+
+// Pops the current string, returns whether there are more
+static bool send_string_async_finish(bool completed) {
+    send_string_async_entry_t entry = send_string_async_queue[send_string_async_head];
+
+    send_string_async_head = (send_string_async_head + 1) % SEND_STRING_ASYNC_QUEUE_SIZE;
+    send_string_async_count--;
+    if (entry.callback) {
+        entry.callback(completed, entry.cb_arg);
+    }
+    return send_string_async_count > 0;
+}
+
+static uint32_t send_string_async_callback(uint32_t trigger_time, void *cb_arg) {
+    const deferred_token token = send_string_async_token;
+
+    while (send_string_async_count > 0) {
+        send_string_async_entry_t *entry = &send_string_async_queue[send_string_async_head];
+
+        if (send_string_async_key_index < send_string_async_key_count) {
+            // With no interval, the whole character is sent at once
+            do {
+                uint16_t key = send_string_async_keys[send_string_async_key_index++];
+                if (key & SEND_STRING_ASYNC_PRESS) {
+                    register_code(key & 0xFF);
+                } else {
+                    unregister_code(key & 0xFF);
+                }
+            } while (send_string_async_key_index < send_string_async_key_count && !entry->interval);
+            return entry->interval ? entry->interval : 1;
+        }
+
+        send_string_async_key_count = 0;
+        send_string_async_key_index = 0;
+        if (entry->ended) {
+            send_string_async_finish(true);
+            if (send_string_async_token != token) {
+                // Cancelled from the callback
+                return 0;
+            }
+            continue;
+        }
+
+        uint32_t delay = send_string_async_read(entry);
+        if (delay) {
+            return delay;
+        }
+    }
+
+    send_string_async_token = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+bool send_string_async_impl(char (*getter)(void *), const void *arg, uint8_t arg_size, uint8_t interval, send_string_async_callback_t callback, void *cb_arg) {
+    if (send_string_async_count >= SEND_STRING_ASYNC_QUEUE_SIZE || arg_size > sizeof(send_string_async_queue[0].arg)) {
+        return false;
+    }
+
+    send_string_async_entry_t *entry = &send_string_async_queue[(send_string_async_head + send_string_async_count) % SEND_STRING_ASYNC_QUEUE_SIZE];
+    *entry                           = (send_string_async_entry_t){
+        .getter   = getter,
+        .interval = interval,
+        .callback = callback,
+        .cb_arg   = cb_arg,
+    };
+    memcpy(entry->arg, arg, arg_size);
+
+    // Started on the next pass of the main loop, unless already typing
+    if (send_string_async_token == INVALID_DEFERRED_TOKEN) {
+        send_string_async_last_exec = timer_read32();
+        send_string_async_token     = defer_exec_advanced(send_string_async_executor, 1, 1, send_string_async_callback, NULL);
+        if (send_string_async_token == INVALID_DEFERRED_TOKEN) {
+            return false;
+        }
+    }
+
+    send_string_async_count++;
+    return true;
+}
+
+bool send_string_async(const char *string) {
+    return send_string_async_with_delay(string, TAP_CODE_DELAY, NULL, NULL);
+}
+
+bool send_string_async_with_delay(const char *string, uint8_t interval, send_string_async_callback_t callback, void *cb_arg) {
+    send_string_memory_state_t state = {string};
+    return send_string_async_impl(send_string_get_next_ram, &state, sizeof(state), interval, callback, cb_arg);
+}
+
+#    if defined(__AVR__)
+bool send_string_async_with_delay_P(const char *string, uint8_t interval, send_string_async_callback_t callback, void *cb_arg) {
+    send_string_memory_state_t state = {string};
+    return send_string_async_impl(send_string_get_next_progmem, &state, sizeof(state), interval, callback, cb_arg);
+}
+#    endif
+
+bool send_string_async_is_active(void) {
+    return send_string_async_count > 0;
+}
+
+bool send_string_async_is_mid_character(void) {
+    return send_string_async_key_index < send_string_async_key_count;
+}
+
+void send_string_async_cancel(void) {
+    if (send_string_async_token != INVALID_DEFERRED_TOKEN) {
+        cancel_deferred_exec_advanced(send_string_async_executor, 1, send_string_async_token);
+        send_string_async_token = INVALID_DEFERRED_TOKEN;
+    }
+
+    // Release what the current character pressed
+    while (send_string_async_key_index < send_string_async_key_count) {
+        uint16_t key = send_string_async_keys[send_string_async_key_index++];
+        if (!(key & SEND_STRING_ASYNC_PRESS)) {
+            unregister_code(key & 0xFF);
+        }
+    }
+    send_string_async_key_count = 0;
+    send_string_async_key_index = 0;
+
+    // Strings queued by the callbacks are kept
+    for (uint8_t cancelled = send_string_async_count; cancelled > 0; cancelled--) {
+        send_string_async_finish(false);
+    }
+}
+
+void send_string_async_task(void) {
+    deferred_exec_advanced_task(send_string_async_executor, 1, &send_string_async_last_exec);
+}
+#endif
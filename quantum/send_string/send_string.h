@@ -24,6 +24,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "progmem.h"
 #include "send_string_keycodes.h"
@@ -169,4 +170,88 @@ void send_string_with_delay_P(const char *string, uint8_t interval);
  */
 void send_string_with_delay_impl(char (*getter)(void *), void *arg, uint8_t interval);
 
+#if defined(SEND_STRING_ASYNC_ENABLE) || defined(__DOXYGEN__)
+#    ifndef SEND_STRING_ASYNC_QUEUE_SIZE
+#        define SEND_STRING_ASYNC_QUEUE_SIZE 4
+#    endif
+
+/**
+ * \brief Called when an asynchronous string is done.
+ *
+ * \param completed `true` if the whole string was typed, `false` if it was cancelled.
+ * \param cb_arg The argument passed along with the string.
+ */
+typedef void (*send_string_async_callback_t)(bool completed, void *cb_arg);
+
+/**
+ * \brief Type out a string of ASCII characters in the background, while the keyboard keeps scanning.
+ *
+ * This function simply calls `send_string_async_with_delay(string, TAP_CODE_DELAY, NULL, NULL)`.
+ *
+ * \param string The string to type out. It is not copied, so it must stay valid until it has been typed.
+ * \return `false` if the queue is full.
+ */
+bool send_string_async(const char *string);
+
+/**
+ * \brief Type out a string of ASCII characters in the background, with a delay between each key press and release.
+ *
+ * Strings are queued, and typed one after the other. Keys pressed on the keyboard meanwhile are held back while a
+ * character is being typed, and processed in order between two characters.
+ *
+ * \param string The string to type out. It is not copied, so it must stay valid until it has been typed.
+ * \param interval The amount of time, in milliseconds, to wait between two key events.
+ * \param callback Called once the string is done, or `NULL`.
+ * \param cb_arg Passed to the callback.
+ * \return `false` if the queue is full.
+ */
+bool send_string_async_with_delay(const char *string, uint8_t interval, send_string_async_callback_t callback, void *cb_arg);
+
+#    if defined(__AVR__) || defined(__DOXYGEN__)
+/**
+ * \brief Type out a PROGMEM string of ASCII characters in the background.
+ *
+ * On ARM devices, this function is simply an alias for send_string_async_with_delay(string, interval, callback, cb_arg).
+ */
+bool send_string_async_with_delay_P(const char *string, uint8_t interval, send_string_async_callback_t callback, void *cb_arg);
+#    else
+#        define send_string_async_with_delay_P(string, interval, callback, cb_arg) send_string_async_with_delay(string, interval, callback, cb_arg)
+#    endif
+
+/**
+ * \brief Shortcut macro for send_string_async_with_delay_P(PSTR(string), 0, NULL, NULL).
+ */
+#    define SEND_STRING_ASYNC(string) send_string_async_with_delay_P(PSTR(string), 0, NULL, NULL)
+
+/**
+ * \brief Queue the string returned by the getter function, to be typed in the background.
+ *
+ * Unlike `send_string_with_delay_impl()`, the getter's state is copied into the queue, up to 8 bytes.
+ */
+bool send_string_async_impl(char (*getter)(void *), const void *arg, uint8_t arg_size, uint8_t interval, send_string_async_callback_t callback, void *cb_arg);
+
+/**
+ * \brief Whether a string is being typed in the background.
+ */
+bool send_string_async_is_active(void);
+
+/**
+ * \brief Whether some key events of the character being typed in the background are still to be sent.
+ */
+bool send_string_async_is_mid_character(void);
+
+/**
+ * \brief Stop typing, and drop every queued string.
+ *
+ * The keys of the character being typed are released, and the callbacks are called with `completed` set to `false`.
+ * Keys pressed with `SS_DOWN()` stay pressed.
+ */
+void send_string_async_cancel(void);
+
+/**
+ * \brief Types the next part of the queued strings, called from the main loop.
+ */
+void send_string_async_task(void);
+#endif
+
 /** \} */
@@ -0,0 +1,102 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \brief Storage layouts for the source layers cache.
+ *
+ * The source layers cache remembers which layer each pressed key was resolved
+ * on, so that its release is handled on the same layer. Three layouts are
+ * available:
+ *
+ * - `SOURCE_LAYERS_CACHE_BIT_PLANES`: one bit plane per layer bit, smallest
+ *   but every access loops over `MAX_LAYER_BITS` planes.
+ * - `SOURCE_LAYERS_CACHE_NIBBLES`: four bits per entry, requires at most 16 layers.
+ * - `SOURCE_LAYERS_CACHE_BYTES`: one byte per entry.
+ *
+ * Unless `SOURCE_LAYERS_CACHE_LAYOUT` is set, bytes are used for matrices of up
+ * to `SOURCE_LAYERS_CACHE_BYTES_MAX_KEYS` keys, then nibbles if the layer count
+ * allows it, then bit planes.
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include "action_layer.h"
+
+#define SOURCE_LAYERS_CACHE_BIT_PLANES 0
+#define SOURCE_LAYERS_CACHE_NIBBLES 1
+#define SOURCE_LAYERS_CACHE_BYTES 2
+
+#ifndef SOURCE_LAYERS_CACHE_BYTES_MAX_KEYS
+#    define SOURCE_LAYERS_CACHE_BYTES_MAX_KEYS 64
+#endif
+
+#ifndef SOURCE_LAYERS_CACHE_LAYOUT
+#    if (MATRIX_ROWS * MATRIX_COLS) <= SOURCE_LAYERS_CACHE_BYTES_MAX_KEYS
+#        define SOURCE_LAYERS_CACHE_LAYOUT SOURCE_LAYERS_CACHE_BYTES
+#    elif MAX_LAYER_BITS <= 4
+#        define SOURCE_LAYERS_CACHE_LAYOUT SOURCE_LAYERS_CACHE_NIBBLES
+#    else
+#        define SOURCE_LAYERS_CACHE_LAYOUT SOURCE_LAYERS_CACHE_BIT_PLANES
+#    endif
+#endif
+
+#if SOURCE_LAYERS_CACHE_LAYOUT == SOURCE_LAYERS_CACHE_NIBBLES && MAX_LAYER_BITS > 4
+#    error "SOURCE_LAYERS_CACHE_NIBBLES supports at most 16 layers"
+#endif
+
+#define SOURCE_LAYERS_CACHE_BIT_PLANES_SIZE(entries) ((((entries) + (CHAR_BIT)-1) / (CHAR_BIT)) * MAX_LAYER_BITS)
+#define SOURCE_LAYERS_CACHE_NIBBLES_SIZE(entries) (((entries) + 1) / 2)
+#define SOURCE_LAYERS_CACHE_BYTES_SIZE(entries) (entries)
+
+static inline void source_layers_cache_update_bit_planes(uint8_t cache[], uint16_t entry_number, uint8_t layer) {
+    uint8_t      *planes      = &cache[(entry_number / (CHAR_BIT)) * MAX_LAYER_BITS];
+    const uint8_t storage_bit = entry_number % (CHAR_BIT);
+    for (uint8_t bit_number = 0; bit_number < MAX_LAYER_BITS; bit_number++) {
+        planes[bit_number] ^= (-((layer & (1U << bit_number)) != 0) ^ planes[bit_number]) & (1U << storage_bit);
+    }
+}
+
+static inline uint8_t source_layers_cache_read_bit_planes(const uint8_t cache[], uint16_t entry_number) {
+    const uint8_t *planes      = &cache[(entry_number / (CHAR_BIT)) * MAX_LAYER_BITS];
+    const uint8_t  storage_bit = entry_number % (CHAR_BIT);
+    uint8_t        layer       = 0;
+    for (uint8_t bit_number = 0; bit_number < MAX_LAYER_BITS; bit_number++) {
+        layer |= ((planes[bit_number] & (1U << storage_bit)) != 0) << bit_number;
+    }
+    return layer;
+}
+
+static inline void source_layers_cache_update_nibbles(uint8_t cache[], uint16_t entry_number, uint8_t layer) {
+    const uint8_t shift = (entry_number & 1) * 4;
+    cache[entry_number / 2] = (cache[entry_number / 2] & ~(0x0F << shift)) | ((layer & 0x0F) << shift);
+}
+
+static inline uint8_t source_layers_cache_read_nibbles(const uint8_t cache[], uint16_t entry_number) {
+    return (cache[entry_number / 2] >> ((entry_number & 1) * 4)) & 0x0F;
+}
+
+static inline void source_layers_cache_update_bytes(uint8_t cache[], uint16_t entry_number, uint8_t layer) {
+    cache[entry_number] = layer;
+}
+
+static inline uint8_t source_layers_cache_read_bytes(const uint8_t cache[], uint16_t entry_number) {
+    return cache[entry_number];
+}
+
+#if SOURCE_LAYERS_CACHE_LAYOUT == SOURCE_LAYERS_CACHE_BYTES
+#    define SOURCE_LAYERS_CACHE_SIZE(entries) SOURCE_LAYERS_CACHE_BYTES_SIZE(entries)
+#    define source_layers_cache_update(cache, entry_number, layer) source_layers_cache_update_bytes(cache, entry_number, layer)
+#    define source_layers_cache_read(cache, entry_number) source_layers_cache_read_bytes(cache, entry_number)
+#elif SOURCE_LAYERS_CACHE_LAYOUT == SOURCE_LAYERS_CACHE_NIBBLES
+#    define SOURCE_LAYERS_CACHE_SIZE(entries) SOURCE_LAYERS_CACHE_NIBBLES_SIZE(entries)
+#    define source_layers_cache_update(cache, entry_number, layer) source_layers_cache_update_nibbles(cache, entry_number, layer)
+#    define source_layers_cache_read(cache, entry_number) source_layers_cache_read_nibbles(cache, entry_number)
+#else
+#    define SOURCE_LAYERS_CACHE_SIZE(entries) SOURCE_LAYERS_CACHE_BIT_PLANES_SIZE(entries)
+#    define source_layers_cache_update(cache, entry_number, layer) source_layers_cache_update_bit_planes(cache, entry_number, layer)
+#    define source_layers_cache_read(cache, entry_number) source_layers_cache_read_bit_planes(cache, entry_number)
+#endif
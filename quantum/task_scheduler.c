@@ -0,0 +1,107 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "task_scheduler.h"
+#include "timer.h"
+
+typedef struct {
+    uint16_t period;
+    uint16_t budget;
+    uint32_t last_run;
+    uint32_t started;
+    uint16_t overruns;
+    uint16_t deferrals;
+    uint8_t  deferred_passes;
+    bool     has_run;
+} task_state_t;
+
+static task_state_t tasks[TASK_SCHEDULER_COUNT];
+static uint32_t     loop_start    = 0;
+static uint16_t     max_loop_time = 0;
+static bool         initialized   = false;
+
+static void task_scheduler_init(void) {
+    for (uint8_t i = 0; i < TASK_SCHEDULER_COUNT; i++) {
+        tasks[i].budget = TASK_SCHEDULER_DEFAULT_BUDGET;
+    }
+    initialized = true;
+}
+
+void task_scheduler_loop_begin(void) {
+    if (!initialized) {
+        task_scheduler_init();
+    }
+
+    const uint32_t now = timer_read32();
+    if (loop_start) {
+        uint32_t loop_time = TIMER_DIFF_32(now, loop_start);
+        if (loop_time > max_loop_time) {
+            max_loop_time = loop_time > UINT16_MAX ? UINT16_MAX : loop_time;
+        }
+    }
+    loop_start = now;
+}
+
+bool task_scheduler_should_run(task_scheduler_task_t task) {
+    task_state_t  *state = &tasks[task];
+    const uint32_t now   = timer_read32();
+
+    if (state->period && state->has_run && TIMER_DIFF_32(now, state->last_run) < state->period) {
+        return false;
+    }
+
+    // Out of time for this pass, unless the task has already waited too long
+    if (TIMER_DIFF_32(now, loop_start) >= TASK_SCHEDULER_LOOP_BUDGET && state->deferred_passes < TASK_SCHEDULER_MAX_DEFERRALS) {
+        state->deferred_passes++;
+        if (state->deferrals < UINT16_MAX) {
+            state->deferrals++;
+        }
+        return false;
+    }
+
+    state->deferred_passes = 0;
+    state->started         = now;
+    return true;
+}
+
+void task_scheduler_done(task_scheduler_task_t task) {
+    task_state_t  *state = &tasks[task];
+    const uint32_t now   = timer_read32();
+
+    if (TIMER_DIFF_32(now, state->started) > state->budget && state->overruns < UINT16_MAX) {
+        state->overruns++;
+    }
+    state->last_run = now;
+    state->has_run  = true;
+}
+
+void task_scheduler_set_period(task_scheduler_task_t task, uint16_t period) {
+    tasks[task].period = period;
+}
+
+void task_scheduler_set_budget(task_scheduler_task_t task, uint16_t budget) {
+    if (!initialized) {
+        task_scheduler_init();
+    }
+    tasks[task].budget = budget;
+}
+
+uint16_t task_scheduler_get_overruns(task_scheduler_task_t task) {
+    return tasks[task].overruns;
+}
+
+uint16_t task_scheduler_get_deferrals(task_scheduler_task_t task) {
+    return tasks[task].deferrals;
+}
+
+uint16_t task_scheduler_get_max_loop_time(void) {
+    return max_loop_time;
+}
+
+void task_scheduler_reset_counters(void) {
+    for (uint8_t i = 0; i < TASK_SCHEDULER_COUNT; i++) {
+        tasks[i].overruns  = 0;
+        tasks[i].deferrals = 0;
+    }
+    max_loop_time = 0;
+}
@@ -0,0 +1,105 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/**
+ * \file
+ *
+ * \defgroup task_scheduler Task Scheduler API
+ *
+ * \brief Deadline aware scheduling of the deferrable parts of `keyboard_task()`.
+ *
+ * Matrix scanning, key processing and report sending always run first. The
+ * lower priority subsystems (lighting, displays, ...) each have a period and a
+ * time budget, and are skipped for the current pass once the pass has used up
+ * `TASK_SCHEDULER_LOOP_BUDGET` milliseconds. A skipped task stays due and
+ * is retried on the next pass, in the same priority order.
+ *
+ * \{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef TASK_SCHEDULER_LOOP_BUDGET
+#    define TASK_SCHEDULER_LOOP_BUDGET 2
+#endif
+
+#ifndef TASK_SCHEDULER_DEFAULT_BUDGET
+#    define TASK_SCHEDULER_DEFAULT_BUDGET 1
+#endif
+
+#ifndef TASK_SCHEDULER_MAX_DEFERRALS
+#    define TASK_SCHEDULER_MAX_DEFERRALS 8
+#endif
+
+/** \brief Deferrable tasks, in priority order
+ */
+typedef enum {
+    TASK_SCHEDULER_RGBLIGHT,
+    TASK_SCHEDULER_LED_MATRIX,
+    TASK_SCHEDULER_RGB_MATRIX,
+    TASK_SCHEDULER_BACKLIGHT,
+    TASK_SCHEDULER_OLED,
+    TASK_SCHEDULER_ST7565,
+    TASK_SCHEDULER_MIDI,
+    TASK_SCHEDULER_BATTERY,
+    TASK_SCHEDULER_HAPTIC,
+    TASK_SCHEDULER_OS_DETECTION,
+    TASK_SCHEDULER_COUNT,
+} task_scheduler_task_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Mark the start of a main loop pass
+ */
+void task_scheduler_loop_begin(void);
+
+/** \brief Check whether a task is due and fits in the current pass
+ *
+ * \return true if the task should run now, in which case `task_scheduler_done()` must follow
+ */
+bool task_scheduler_should_run(task_scheduler_task_t task);
+
+/** \brief Mark a task as completed for this pass and account its run time
+ */
+void task_scheduler_done(task_scheduler_task_t task);
+
+/** \brief Set the minimum interval in milliseconds between two runs of a task - `0` to run every pass
+ */
+void task_scheduler_set_period(task_scheduler_task_t task, uint16_t period);
+
+/** \brief Set the time budget in milliseconds of a single run of a task
+ */
+void task_scheduler_set_budget(task_scheduler_task_t task, uint16_t budget);
+
+/** \brief Number of runs that took longer than the task's budget
+ */
+uint16_t task_scheduler_get_overruns(task_scheduler_task_t task);
+
+/** \brief Number of passes on which a due task was skipped to protect the scan interval
+ */
+uint16_t task_scheduler_get_deferrals(task_scheduler_task_t task);
+
+/** \brief Longest main loop pass seen, in milliseconds
+ */
+uint16_t task_scheduler_get_max_loop_time(void);
+
+/** \brief Clear all overrun and deferral counters
+ */
+void task_scheduler_reset_counters(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifndef TASK_SCHEDULER_ENABLE
+#    define task_scheduler_loop_begin()
+#    define task_scheduler_should_run(task) true
+#    define task_scheduler_done(task)
+#endif
+
+/** \} */
@@ -31,6 +31,10 @@
 #    include "audio.h"
 #endif
 
+#ifdef UNICODE_PACKED
+#    include "report.h"
+#endif
+
 #if defined(UNICODE_ENABLE) + defined(UNICODEMAP_ENABLE) + defined(UCIS_ENABLE) > 1
 #    error "Cannot enable more than one Unicode method (UNICODE, UNICODEMAP, UCIS) at the same time"
 #endif
@@ -62,6 +66,14 @@
 #    define UNICODE_TYPE_DELAY 10
 #endif
 
+// Time each report of packed hex digits is held, in ms
+#if defined(UNICODE_PACKED) && !defined(UNICODE_PACKED_INTERVAL)
+#    define UNICODE_PACKED_INTERVAL KEYBOARD_REPORT_POLL_INTERVAL
+#endif
+
+// Longest hex sequence of a code point: a surrogate pair on macOS
+#define UNICODE_MAX_DIGITS 8
+
 unicode_config_t unicode_config;
 uint8_t          unicode_saved_mods;
 led_t            unicode_saved_led_state;
@@ -331,9 +343,11 @@ void register_hex(uint16_t hex) {
     }
 }
 
-void register_hex32(uint32_t hex) {
-    bool first_digit        = true;
-    bool needs_leading_zero = (unicode_config.input_mode == UNICODE_MODE_WINCOMPOSE);
+// Fills in the digits register_hex32() sends for the number, returns how many there are
+static uint8_t hex32_digits(uint32_t hex, uint8_t *digits) {
+    uint8_t count              = 0;
+    bool    first_digit        = true;
+    bool    needs_leading_zero = (unicode_config.input_mode == UNICODE_MODE_WINCOMPOSE);
     for (int i = 7; i >= 0; i--) {
         // Work out the digit we're going to transmit
         uint8_t digit = ((hex >> (i * 4)) & 0xF);
@@ -341,7 +355,7 @@ void register_hex32(uint32_t hex) {
         // If we're still searching for the first digit, and found one
         // that needs a leading zero sent out, send the zero.
         if (first_digit && needs_leading_zero && digit > 9) {
-            send_nibble_wrapper(0);
+            digits[count++] = 0;
         }
 
         // Always send digits (including zero) if we're down to the last
@@ -350,28 +364,125 @@ void register_hex32(uint32_t hex) {
 
         // If we've found a digit worth transmitting, do so.
         if (digit != 0 || !first_digit || must_send) {
-            send_nibble_wrapper(digit);
-            first_digit = false;
+            digits[count++] = digit;
+            first_digit     = false;
+        }
+    }
+    return count;
+}
+
+void register_hex32(uint32_t hex) {
+    uint8_t digits[UNICODE_MAX_DIGITS + 1];
+    uint8_t count = hex32_digits(hex, digits);
+    for (uint8_t i = 0; i < count; i++) {
+        send_nibble_wrapper(digits[i]);
+    }
+}
+
+#ifdef UNICODE_PACKED
+// Keycodes of the hex digits in the input mode they were worked out for, KC_NO for those needing modifiers
+static uint8_t digit_keycodes[16];
+static uint8_t digit_keycodes_mode = UNICODE_MODE_COUNT;
+
+static void update_digit_keycodes(void) {
+    if (digit_keycodes_mode == unicode_config.input_mode) {
+        return;
+    }
+    digit_keycodes_mode = unicode_config.input_mode;
+
+    for (uint8_t digit = 0; digit < 16; digit++) {
+        if (unicode_config.input_mode == UNICODE_MODE_WINDOWS) {
+            // Same keys as send_nibble_wrapper()
+            digit_keycodes[digit] = digit < 10 ? KC_KP_1 + (10 + digit - 1) % 10 : KC_A + (digit - 10);
+            continue;
+        }
+
+        // Same keys as send_nibble(), which types the digit with the host's keyboard layout
+        uint8_t ascii_code = digit < 10 ? '0' + digit : 'a' + (digit - 10);
+        uint8_t keycode    = pgm_read_byte(&ascii_to_keycode_lut[ascii_code]);
+        if ((pgm_read_byte(&ascii_to_shift_lut[ascii_code / 8]) | pgm_read_byte(&ascii_to_altgr_lut[ascii_code / 8]) | pgm_read_byte(&ascii_to_dead_lut[ascii_code / 8])) & (1 << (ascii_code % 8))) {
+            keycode = KC_NO;
         }
+        digit_keycodes[digit] = keycode;
     }
 }
 
+// Sends the digits with as many of them in each report as possible
+static void send_digits_packed(const uint8_t *digits, uint8_t count) {
+    update_digit_keycodes();
+
+    uint8_t i = 0;
+    while (i < count) {
+        uint8_t keys[KEYBOARD_REPORT_KEYS];
+        uint8_t key_count = 0;
+        uint8_t capacity  = MIN(get_keyboard_report_free_keys(), KEYBOARD_REPORT_KEYS);
+
+        while (i < count && key_count < capacity) {
+            uint8_t keycode = digit_keycodes[digits[i]];
+            bool    fits    = keycode != KC_NO && !is_key_pressed(keycode);
+            for (uint8_t j = 0; fits && j < key_count; j++) {
+                // A repeated digit needs a release in between
+                fits = keys[j] != keycode;
+            }
+            if (fits && key_count) {
+                // Keys in a report have no order, hosts may see them in keycode order
+                fits = keys[key_count - 1] < keycode;
+            }
+            if (!fits) {
+                break;
+            }
+            keys[key_count++] = keycode;
+            i++;
+        }
+
+        if (!key_count) {
+            send_nibble_wrapper(digits[i++]);
+            continue;
+        }
+
+        for (uint8_t j = 0; j < key_count; j++) {
+            add_key(keys[j]);
+        }
+        send_keyboard_report();
+        wait_ms(UNICODE_PACKED_INTERVAL);
+
+        for (uint8_t j = 0; j < key_count; j++) {
+            del_key(keys[j]);
+        }
+        send_keyboard_report();
+        wait_ms(UNICODE_PACKED_INTERVAL);
+    }
+}
+#endif
+
 void register_unicode(uint32_t code_point) {
     if (code_point > 0x10FFFF || (code_point > 0xFFFF && unicode_config.input_mode == UNICODE_MODE_WINDOWS)) {
         // Code point out of range, do nothing
         return;
     }
 
-    unicode_input_start();
+    // Work out the whole sequence first, so it is sent without pausing in between
+    uint8_t digits[UNICODE_MAX_DIGITS + 1];
+    uint8_t count;
     if (code_point > 0xFFFF && unicode_config.input_mode == UNICODE_MODE_MACOS) {
         // Convert code point to UTF-16 surrogate pair on macOS
         code_point -= 0x10000;
         uint32_t lo = code_point & 0x3FF, hi = (code_point & 0xFFC00) >> 10;
-        register_hex32(hi + 0xD800);
-        register_hex32(lo + 0xDC00);
+
+        count  = hex32_digits(hi + 0xD800, digits);
+        count += hex32_digits(lo + 0xDC00, &digits[count]);
     } else {
-        register_hex32(code_point);
+        count = hex32_digits(code_point, digits);
     }
+
+    unicode_input_start();
+#ifdef UNICODE_PACKED
+    send_digits_packed(digits, count);
+#else
+    for (uint8_t i = 0; i < count; i++) {
+        send_nibble_wrapper(digits[i]);
+    }
+#endif
     unicode_input_finish();
 }
 
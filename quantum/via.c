@@ -37,6 +37,10 @@
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 #include "nvm_via.h"
 
+#ifdef DYNAMIC_COMBO_ENABLE
+#    include "dynamic_combo.h"
+#endif
+
 #if defined(SECURE_ENABLE)
 #    include "secure.h"
 #endif
@@ -65,6 +69,10 @@
 #    include "led_matrix.h"
 #endif
 
+#if defined(PROFILING_ENABLE)
+#    include "profiling.h"
+#endif
+
 // Can be called in an overriding via_init_kb() to test if keyboard level code usage of
 // EEPROM is invalid and use/save defaults.
 bool via_eeprom_is_valid(void) {
@@ -128,6 +136,10 @@ void eeconfig_init_via(void) {
     dynamic_keymap_reset();
     // This resets the macros in EEPROM to nothing.
     dynamic_keymap_macro_reset();
+#ifdef DYNAMIC_COMBO_ENABLE
+    // This resets the combos in EEPROM to nothing.
+    dynamic_combo_reset();
+#endif
     // Save the magic number last, in case saving was interrupted
     via_eeprom_set_valid(true);
 }
@@ -297,6 +309,12 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
         return;
     }
 
+#ifdef PROFILING_ENABLE
+    if (profiling_raw_hid_receive(data, length)) {
+        return;
+    }
+#endif
+
     switch (*command_id) {
         case id_get_protocol_version: {
             command_data[0] = VIA_PROTOCOL_VERSION >> 8;
@@ -467,6 +485,33 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             dynamic_keymap_set_encoder(command_data[0], command_data[1], command_data[2] != 0, (command_data[3] << 8) | command_data[4]);
             break;
         }
+#endif
+#ifdef DYNAMIC_COMBO_ENABLE
+        case id_dynamic_combo_get_count: {
+            command_data[0] = dynamic_combo_get_count();
+            command_data[1] = dynamic_combo_get_key_count();
+            break;
+        }
+        case id_dynamic_combo_get_buffer: {
+            uint16_t offset = (command_data[0] << 8) | command_data[1];
+            uint16_t size   = command_data[2]; // size <= 28
+            dynamic_combo_get_buffer(offset, size, &command_data[3]);
+            break;
+        }
+        case id_dynamic_combo_set_buffer: {
+            uint16_t offset = (command_data[0] << 8) | command_data[1];
+            uint16_t size   = command_data[2]; // size <= 28
+            dynamic_combo_set_buffer(offset, size, &command_data[3]);
+            break;
+        }
+        case id_dynamic_combo_commit: {
+            dynamic_combo_commit();
+            break;
+        }
+        case id_dynamic_combo_reset: {
+            dynamic_combo_reset();
+            break;
+        }
 #endif
         default: {
             // The command ID is not known
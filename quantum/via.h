@@ -73,6 +73,11 @@ enum via_command_id {
     id_dynamic_keymap_set_buffer            = 0x13,
     id_dynamic_keymap_get_encoder           = 0x14,
     id_dynamic_keymap_set_encoder           = 0x15,
+    id_dynamic_combo_get_count              = 0x16,
+    id_dynamic_combo_get_buffer             = 0x17,
+    id_dynamic_combo_set_buffer             = 0x18,
+    id_dynamic_combo_commit                 = 0x19,
+    id_dynamic_combo_reset                  = 0x1A,
     id_unhandled                            = 0xFF,
 };
 
@@ -0,0 +1,105 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "action_table.h"
+#include "keycode_config.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class ActionTable : public TestFixture {};
+
+TEST_F(ActionTable, MatchesTranslatedKeycodes) {
+    const uint16_t keycodes[] = {KC_A, KC_LSFT, KC_TRNS, LCTL(KC_C), LT(1, KC_SPC), MT(MOD_LALT, KC_TAB), MO(1), TG(1), OSM(MOD_RGUI), QK_BOOT};
+
+    // Layer 2 is past ACTION_TABLE_LAYERS and uses the fallback
+    for (uint8_t layer = 0; layer < 3; layer++) {
+        for (uint8_t col = 0; col < sizeof(keycodes) / sizeof(keycodes[0]); col++) {
+            add_key(KeymapKey(layer, col, layer, keycodes[col]));
+        }
+    }
+
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        for (uint8_t layer = 0; layer < 3; layer++) {
+            for (uint8_t col = 0; col < sizeof(keycodes) / sizeof(keycodes[0]); col++) {
+                keypos_t key = {.col = col, .row = layer};
+                EXPECT_EQ(action_for_key(layer, key).code, action_for_keycode(keycodes[col]).code) << "layer " << +layer << " col " << +col;
+            }
+        }
+    }
+}
+
+TEST_F(ActionTable, KeymapConfigChangeIsSeen) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_lctl = KeymapKey(0, 0, 0, KC_LCTL);
+
+    set_keymap({key_lctl});
+
+    EXPECT_REPORT(driver, (KC_LCTL));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_lctl);
+    VERIFY_AND_CLEAR(driver);
+
+    keymap_config.swap_lctl_lgui = true;
+    EXPECT_REPORT(driver, (KC_LGUI));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_lctl);
+    VERIFY_AND_CLEAR(driver);
+
+    keymap_config.swap_lctl_lgui = false;
+    EXPECT_REPORT(driver, (KC_LCTL));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_lctl);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ActionTable, KeymapChangeIsSeen) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 0, 0, KC_B);
+
+    set_keymap({key_a});
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    set_keymap({key_b});
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_b);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ActionTable, TransparentKeyFallsThrough) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a       = KeymapKey(0, 0, 0, KC_A);
+    auto       key_a_trans = KeymapKey(1, 0, 0, KC_TRNS);
+    auto       key_b       = KeymapKey(3, 1, 0, KC_B);
+
+    set_keymap({key_a, key_a_trans, KeymapKey(3, 0, 0, KC_TRNS), key_b, KeymapKey(0, 1, 0, KC_NO), KeymapKey(1, 1, 0, KC_TRNS)});
+    layer_on(1);
+    layer_on(3);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_b);
+    VERIFY_AND_CLEAR(driver);
+
+    layer_clear();
+}
@@ -0,0 +1,76 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.h"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "quantum.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class ComboBitmaskState : public TestFixture {};
+
+TEST_F(ComboBitmaskState, chord_of_twenty_keys) {
+    TestDriver             driver;
+    InSequence             s;
+    std::vector<KeymapKey> chord;
+    for (uint8_t i = 0; i < 20; i++) {
+        chord.push_back(KeymapKey(0, i % 10, i / 10, KC_A + i));
+        add_key(chord.back());
+    }
+
+    EXPECT_REPORT(driver, (KC_1));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo(chord);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboBitmaskState, combos_sharing_keys_are_told_apart) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_u(0, 1, 0, KC_U);
+    KeymapKey  key_v(0, 2, 0, KC_V);
+    KeymapKey  key_w(0, 3, 0, KC_W);
+    set_keymap({key_u, key_v, key_w});
+
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_u, key_v});
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_3));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_w, key_v});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboBitmaskState, combo_key_alone_is_sent) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_v(0, 1, 0, KC_V);
+    set_keymap({key_v});
+
+    EXPECT_REPORT(driver, (KC_V));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_v);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboBitmaskState, key_outside_every_combo_is_not_held) {
+    keyrecord_t record = {};
+    record.event.type  = KEY_EVENT;
+
+    for (int i = 0; i < 4; i++) {
+        record.event.pressed = !(i & 1);
+        EXPECT_TRUE(process_combo(KC_SPACE, &record));
+    }
+}
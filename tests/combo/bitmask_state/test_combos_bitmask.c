@@ -0,0 +1,128 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+// Longer than the 16 keys of EXTRA_LONG_COMBOS
+uint16_t const chord_combo[] = {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, COMBO_END};
+uint16_t const uv_combo[]    = {KC_U, KC_V, COMBO_END};
+uint16_t const vw_combo[]    = {KC_V, KC_W, COMBO_END};
+
+// Filler combos, so that keys go through a realistic number of them
+uint16_t const f1_combo[]     = {KC_F1, KC_F2, COMBO_END};
+uint16_t const f2_combo[]     = {KC_F2, KC_F3, COMBO_END};
+uint16_t const f3_combo[]     = {KC_F3, KC_F4, COMBO_END};
+uint16_t const f4_combo[]     = {KC_F4, KC_F5, COMBO_END};
+uint16_t const f5_combo[]     = {KC_F5, KC_F6, COMBO_END};
+uint16_t const f6_combo[]     = {KC_F6, KC_F7, COMBO_END};
+uint16_t const f7_combo[]     = {KC_F7, KC_F8, COMBO_END};
+uint16_t const f8_combo[]     = {KC_F8, KC_F9, COMBO_END};
+uint16_t const f9_combo[]     = {KC_F9, KC_F10, COMBO_END};
+uint16_t const f10_combo[]    = {KC_F10, KC_F11, COMBO_END};
+uint16_t const f11_combo[]    = {KC_F11, KC_F12, COMBO_END};
+uint16_t const f12_combo[]    = {KC_F12, KC_F13, COMBO_END};
+uint16_t const f13_combo[]    = {KC_F13, KC_F14, COMBO_END};
+uint16_t const f14_combo[]    = {KC_F14, KC_F15, COMBO_END};
+uint16_t const f15_combo[]    = {KC_F15, KC_F16, COMBO_END};
+uint16_t const f16_combo[]    = {KC_F16, KC_F17, COMBO_END};
+uint16_t const f17_combo[]    = {KC_F17, KC_F18, COMBO_END};
+uint16_t const f18_combo[]    = {KC_F18, KC_F19, COMBO_END};
+uint16_t const f19_combo[]    = {KC_F19, KC_F20, COMBO_END};
+uint16_t const f20_combo[]    = {KC_F20, KC_F21, COMBO_END};
+uint16_t const f21_combo[]    = {KC_F21, KC_F22, COMBO_END};
+uint16_t const f22_combo[]    = {KC_F22, KC_F23, COMBO_END};
+uint16_t const f23_combo[]    = {KC_F23, KC_F24, COMBO_END};
+uint16_t const kp1_combo[]    = {KC_KP_1, KC_KP_2, COMBO_END};
+uint16_t const kp2_combo[]    = {KC_KP_2, KC_KP_3, COMBO_END};
+uint16_t const kp3_combo[]    = {KC_KP_3, KC_KP_4, COMBO_END};
+uint16_t const kp4_combo[]    = {KC_KP_4, KC_KP_5, COMBO_END};
+uint16_t const kp5_combo[]    = {KC_KP_5, KC_KP_6, COMBO_END};
+uint16_t const kp6_combo[]    = {KC_KP_6, KC_KP_7, COMBO_END};
+uint16_t const kp7_combo[]    = {KC_KP_7, KC_KP_8, COMBO_END};
+uint16_t const kp8_combo[]    = {KC_KP_8, KC_KP_9, COMBO_END};
+uint16_t const kp9_combo[]    = {KC_KP_9, KC_KP_0, COMBO_END};
+uint16_t const f1_kp_combo[]  = {KC_F1, KC_F2, KC_KP_1, COMBO_END};
+uint16_t const f2_kp_combo[]  = {KC_F2, KC_F3, KC_KP_2, COMBO_END};
+uint16_t const f3_kp_combo[]  = {KC_F3, KC_F4, KC_KP_3, COMBO_END};
+uint16_t const f4_kp_combo[]  = {KC_F4, KC_F5, KC_KP_4, COMBO_END};
+uint16_t const f5_kp_combo[]  = {KC_F5, KC_F6, KC_KP_5, COMBO_END};
+uint16_t const f6_kp_combo[]  = {KC_F6, KC_F7, KC_KP_6, COMBO_END};
+uint16_t const f7_kp_combo[]  = {KC_F7, KC_F8, KC_KP_7, COMBO_END};
+uint16_t const f8_kp_combo[]  = {KC_F8, KC_F9, KC_KP_8, COMBO_END};
+uint16_t const f9_kp_combo[]  = {KC_F9, KC_F10, KC_KP_9, COMBO_END};
+uint16_t const f10_kp_combo[] = {KC_F10, KC_F11, KC_KP_0, COMBO_END};
+uint16_t const f11_kp_combo[] = {KC_F11, KC_F12, KC_KP_1, COMBO_END};
+uint16_t const f12_kp_combo[] = {KC_F12, KC_F13, KC_KP_2, COMBO_END};
+uint16_t const f13_kp_combo[] = {KC_F13, KC_F14, KC_KP_3, COMBO_END};
+uint16_t const f14_kp_combo[] = {KC_F14, KC_F15, KC_KP_4, COMBO_END};
+uint16_t const f15_kp_combo[] = {KC_F15, KC_F16, KC_KP_5, COMBO_END};
+uint16_t const f16_kp_combo[] = {KC_F16, KC_F17, KC_KP_6, COMBO_END};
+uint16_t const f17_kp_combo[] = {KC_F17, KC_F18, KC_KP_7, COMBO_END};
+uint16_t const f18_kp_combo[] = {KC_F18, KC_F19, KC_KP_8, COMBO_END};
+uint16_t const f19_kp_combo[] = {KC_F19, KC_F20, KC_KP_9, COMBO_END};
+uint16_t const f20_kp_combo[] = {KC_F20, KC_F21, KC_KP_0, COMBO_END};
+uint16_t const f21_kp_combo[] = {KC_F21, KC_F22, KC_KP_1, COMBO_END};
+uint16_t const f22_kp_combo[] = {KC_F22, KC_F23, KC_KP_2, COMBO_END};
+uint16_t const f23_kp_combo[] = {KC_F23, KC_F24, KC_KP_3, COMBO_END};
+
+// clang-format off
+combo_t key_combos[] = {
+    COMBO(chord_combo, KC_1),
+    COMBO(uv_combo, KC_2),
+    COMBO(vw_combo, KC_3),
+    COMBO(f1_combo, KC_Z),
+    COMBO(f2_combo, KC_Z),
+    COMBO(f3_combo, KC_Z),
+    COMBO(f4_combo, KC_Z),
+    COMBO(f5_combo, KC_Z),
+    COMBO(f6_combo, KC_Z),
+    COMBO(f7_combo, KC_Z),
+    COMBO(f8_combo, KC_Z),
+    COMBO(f9_combo, KC_Z),
+    COMBO(f10_combo, KC_Z),
+    COMBO(f11_combo, KC_Z),
+    COMBO(f12_combo, KC_Z),
+    COMBO(f13_combo, KC_Z),
+    COMBO(f14_combo, KC_Z),
+    COMBO(f15_combo, KC_Z),
+    COMBO(f16_combo, KC_Z),
+    COMBO(f17_combo, KC_Z),
+    COMBO(f18_combo, KC_Z),
+    COMBO(f19_combo, KC_Z),
+    COMBO(f20_combo, KC_Z),
+    COMBO(f21_combo, KC_Z),
+    COMBO(f22_combo, KC_Z),
+    COMBO(f23_combo, KC_Z),
+    COMBO(kp1_combo, KC_Z),
+    COMBO(kp2_combo, KC_Z),
+    COMBO(kp3_combo, KC_Z),
+    COMBO(kp4_combo, KC_Z),
+    COMBO(kp5_combo, KC_Z),
+    COMBO(kp6_combo, KC_Z),
+    COMBO(kp7_combo, KC_Z),
+    COMBO(kp8_combo, KC_Z),
+    COMBO(kp9_combo, KC_Z),
+    COMBO(f1_kp_combo, KC_Z),
+    COMBO(f2_kp_combo, KC_Z),
+    COMBO(f3_kp_combo, KC_Z),
+    COMBO(f4_kp_combo, KC_Z),
+    COMBO(f5_kp_combo, KC_Z),
+    COMBO(f6_kp_combo, KC_Z),
+    COMBO(f7_kp_combo, KC_Z),
+    COMBO(f8_kp_combo, KC_Z),
+    COMBO(f9_kp_combo, KC_Z),
+    COMBO(f10_kp_combo, KC_Z),
+    COMBO(f11_kp_combo, KC_Z),
+    COMBO(f12_kp_combo, KC_Z),
+    COMBO(f13_kp_combo, KC_Z),
+    COMBO(f14_kp_combo, KC_Z),
+    COMBO(f15_kp_combo, KC_Z),
+    COMBO(f16_kp_combo, KC_Z),
+    COMBO(f17_kp_combo, KC_Z),
+    COMBO(f18_kp_combo, KC_Z),
+    COMBO(f19_kp_combo, KC_Z),
+    COMBO(f20_kp_combo, KC_Z),
+    COMBO(f21_kp_combo, KC_Z),
+    COMBO(f22_kp_combo, KC_Z),
+    COMBO(f23_kp_combo, KC_Z),
+};
+// clang-format on
@@ -0,0 +1,153 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.h"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "dynamic_combo.h"
+#include "keymap_introspection.h"
+#include "process_combo.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class DynamicCombo : public TestFixture {
+   public:
+    void SetUp() override {
+        dynamic_combo_reset();
+    }
+};
+
+TEST_F(DynamicCombo, stored_combo_fires_next_to_keymap_combos) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_a(0, 1, 0, KC_A);
+    KeymapKey  key_b(0, 2, 0, KC_B);
+    KeymapKey  key_c(0, 3, 0, KC_C);
+    KeymapKey  key_d(0, 4, 0, KC_D);
+    set_keymap({key_a, key_b, key_c, key_d});
+
+    const uint16_t keys[] = {KC_C, KC_D};
+    EXPECT_TRUE(dynamic_combo_set(2, keys, 2, KC_Y));
+    EXPECT_EQ(combo_count(), combo_count_raw() + 1);
+
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_c, key_d});
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_a, key_b});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicCombo, uploaded_combos_wait_for_commit) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_c(0, 3, 0, KC_C);
+    KeymapKey  key_d(0, 4, 0, KC_D);
+    KeymapKey  key_e(0, 5, 0, KC_E);
+    set_keymap({key_c, key_d, key_e});
+
+    // Slot 1 holds C + D + E -> Z, big endian, in two writes
+    uint8_t slot[DYNAMIC_COMBO_SLOT_SIZE] = {0, KC_C, 0, KC_D, 0, KC_E, 0, KC_Z};
+    dynamic_combo_set_buffer(DYNAMIC_COMBO_SLOT_SIZE, 4, slot);
+    dynamic_combo_set_buffer(DYNAMIC_COMBO_SLOT_SIZE + 4, 4, &slot[4]);
+    EXPECT_EQ(combo_count(), combo_count_raw());
+
+    dynamic_combo_commit();
+    EXPECT_EQ(combo_count(), combo_count_raw() + 1);
+
+    EXPECT_REPORT(driver, (KC_Z));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_c, key_d, key_e});
+    VERIFY_AND_CLEAR(driver);
+
+    uint8_t read[DYNAMIC_COMBO_SLOT_SIZE];
+    dynamic_combo_get_buffer(DYNAMIC_COMBO_SLOT_SIZE, sizeof(read), read);
+    EXPECT_EQ(memcmp(read, slot, sizeof(read)), 0);
+}
+
+TEST_F(DynamicCombo, combos_are_loaded_from_nvm) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_c(0, 3, 0, KC_C);
+    KeymapKey  key_d(0, 4, 0, KC_D);
+    set_keymap({key_c, key_d});
+
+    const uint16_t keys[] = {KC_C, KC_D};
+    dynamic_combo_set(0, keys, 2, KC_Y);
+    dynamic_combo_init();
+    EXPECT_EQ(combo_count(), combo_count_raw() + 1);
+
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_c, key_d});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicCombo, reset_and_empty_slots) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_c(0, 3, 0, KC_C);
+    KeymapKey  key_d(0, 4, 0, KC_D);
+    set_keymap({key_c, key_d});
+
+    const uint16_t keys[] = {KC_C, KC_D, KC_E, KC_F};
+    EXPECT_FALSE(dynamic_combo_set(DYNAMIC_COMBO_COUNT, keys, 2, KC_Y));
+    EXPECT_FALSE(dynamic_combo_set(0, keys, 4, KC_Y));
+    EXPECT_TRUE(dynamic_combo_set(0, keys, 2, KC_Y));
+    EXPECT_TRUE(dynamic_combo_set(1, keys, 2, KC_NO));
+    EXPECT_EQ(combo_count(), combo_count_raw() + 1);
+
+    dynamic_combo_reset();
+    EXPECT_EQ(combo_count(), combo_count_raw());
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_REPORT(driver, (KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_c, key_d});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicCombo, changes_wait_for_held_combo) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_c(0, 3, 0, KC_C);
+    KeymapKey  key_d(0, 4, 0, KC_D);
+    set_keymap({key_c, key_d});
+
+    const uint16_t keys[] = {KC_C, KC_D};
+    dynamic_combo_set(0, keys, 2, KC_Y);
+
+    EXPECT_REPORT(driver, (KC_Y));
+    key_c.press();
+    run_one_scan_loop();
+    key_d.press();
+    run_one_scan_loop();
+    idle_for(COMBO_TERM + 1);
+    VERIFY_AND_CLEAR(driver);
+
+    // Neither the upload nor its commit may drop the held combo
+    uint8_t slot[DYNAMIC_COMBO_SLOT_SIZE] = {0};
+    dynamic_combo_set_buffer(0, sizeof(slot), slot);
+    dynamic_combo_commit();
+    EXPECT_EQ(combo_count(), combo_count_raw() + 1);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_c.release();
+    run_one_scan_loop();
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(combo_count(), combo_count_raw());
+}
@@ -0,0 +1,85 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.h"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class ComboKeycodeIndex : public TestFixture {};
+
+TEST_F(ComboKeycodeIndex, combos_sharing_keys_are_told_apart) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_a(0, 1, 0, KC_A);
+    KeymapKey  key_b(0, 2, 0, KC_B);
+    KeymapKey  key_c(0, 3, 0, KC_C);
+    KeymapKey  key_d(0, 4, 0, KC_D);
+    set_keymap({key_a, key_b, key_c, key_d});
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_a, key_b});
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_a, key_c});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeycodeIndex, longer_combo_sharing_keys) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_a(0, 1, 0, KC_A);
+    KeymapKey  key_b(0, 2, 0, KC_B);
+    KeymapKey  key_c(0, 3, 0, KC_C);
+    KeymapKey  key_d(0, 4, 0, KC_D);
+    set_keymap({key_a, key_b, key_c, key_d});
+
+    EXPECT_REPORT(driver, (KC_Z));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_b, key_c, key_d});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeycodeIndex, combo_key_alone_is_sent) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_g(0, 1, 0, KC_G);
+    set_keymap({key_g});
+
+    EXPECT_REPORT(driver, (KC_G));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_g);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeycodeIndex, key_outside_combos_is_sent_right_away) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_f(0, 1, 0, KC_F);
+    KeymapKey  key_g(0, 2, 0, KC_G);
+    KeymapKey  key_q(0, 3, 0, KC_Q);
+    set_keymap({key_f, key_g, key_q});
+
+    EXPECT_REPORT(driver, (KC_Q));
+    key_q.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_q.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_1));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_f, key_g});
+    VERIFY_AND_CLEAR(driver);
+}
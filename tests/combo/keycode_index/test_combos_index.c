@@ -0,0 +1,21 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+enum combos { combo_ab, combo_ac, combo_bcd, combo_fg, combo_gh };
+
+uint16_t const ab_combo[]  = {KC_A, KC_B, COMBO_END};
+uint16_t const ac_combo[]  = {KC_A, KC_C, COMBO_END};
+uint16_t const bcd_combo[] = {KC_B, KC_C, KC_D, COMBO_END};
+uint16_t const fg_combo[]  = {KC_F, KC_G, COMBO_END};
+uint16_t const gh_combo[]  = {KC_G, KC_H, COMBO_END};
+
+// clang-format off
+combo_t key_combos[] = {
+    [combo_ab]  = COMBO(ab_combo, KC_X),
+    [combo_ac]  = COMBO(ac_combo, KC_Y),
+    [combo_bcd] = COMBO(bcd_combo, KC_Z),
+    [combo_fg]  = COMBO(fg_combo, KC_1),
+    [combo_gh]  = COMBO(gh_combo, KC_2),
+};
+// clang-format on
@@ -0,0 +1,81 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class DynamicMacroTiming : public TestFixture {};
+
+TEST_F(DynamicMacroTiming, playback_keeps_the_recorded_delays) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_rec(0, 0, 0, DM_REC1);
+    KeymapKey  key_play(0, 1, 0, DM_PLY1);
+    KeymapKey  key_stop(0, 2, 0, DM_RSTP);
+    KeymapKey  key_a(0, 3, 0, KC_A);
+    KeymapKey  key_b(0, 4, 0, KC_B);
+    set_keymap({key_rec, key_play, key_stop, key_a, key_b});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_rec);
+    tap_key(key_a);
+    idle_for(300);
+    tap_key(key_b);
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    uint16_t start = timer_read();
+    tap_key(key_play);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_GE(timer_elapsed(start), 300);
+}
+
+TEST_F(DynamicMacroTiming, mod_tap_plays_back_as_recorded) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_rec(0, 0, 0, DM_REC1);
+    KeymapKey  key_play(0, 1, 0, DM_PLY1);
+    KeymapKey  key_stop(0, 2, 0, DM_RSTP);
+    KeymapKey  key_mt(0, 3, 0, LSFT_T(KC_A));
+    KeymapKey  key_b(0, 4, 0, KC_B);
+    set_keymap({key_rec, key_play, key_stop, key_mt, key_b});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_B));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_rec);
+    tap_key(key_mt);
+    idle_for(TAPPING_TERM + 1);
+    key_mt.press();
+    idle_for(TAPPING_TERM + 1);
+    tap_key(key_b);
+    key_mt.release();
+    run_one_scan_loop();
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_B));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play);
+    VERIFY_AND_CLEAR(driver);
+}
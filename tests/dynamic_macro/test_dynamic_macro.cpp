@@ -0,0 +1,269 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "process_dynamic_macro.h"
+#include "nvm_dynamic_macro.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class DynamicMacro : public TestFixture {
+   public:
+    KeymapKey key_rec1{0, 0, 0, DM_REC1};
+    KeymapKey key_rec2{0, 1, 0, DM_REC2};
+    KeymapKey key_play1{0, 2, 0, DM_PLY1};
+    KeymapKey key_play2{0, 3, 0, DM_PLY2};
+    KeymapKey key_stop{0, 4, 0, DM_RSTP};
+    KeymapKey key_a{0, 5, 0, KC_A};
+    KeymapKey key_b{0, 6, 0, KC_B};
+    KeymapKey key_c{0, 7, 0, KC_C};
+    KeymapKey key_shift{0, 8, 0, KC_LSFT};
+
+    void SetUp() override {
+        // Start from empty macros
+        nvm_dynamic_macro_update_length(0, 0);
+        nvm_dynamic_macro_update_length(1, 0);
+        dynamic_macro_init();
+
+        set_keymap({key_rec1, key_rec2, key_play1, key_play2, key_stop, key_a, key_b, key_c, key_shift});
+    }
+};
+
+TEST_F(DynamicMacro, records_and_plays_back) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_rec1);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_keys(key_a, key_b);
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, both_macros_share_the_buffer) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_C));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_rec1);
+    tap_key(key_a);
+    tap_key(key_stop);
+    tap_key(key_rec2);
+    key_shift.press();
+    run_one_scan_loop();
+    tap_key(key_c);
+    key_shift.release();
+    run_one_scan_loop();
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_C));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play2);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, trailing_key_down_events_are_dropped) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_rec1);
+    tap_key(key_a);
+    key_b.press();
+    run_one_scan_loop();
+    tap_key(key_stop);
+    key_b.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, recording_stops_filling_a_full_buffer) {
+    TestDriver driver;
+    InSequence s;
+
+    // 32 bytes hold 6 taps of 5 bytes each
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_rec1);
+    tap_keys(key_a, key_b, key_c, key_a, key_b, key_c, key_a);
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, recording_ends_at_the_first_event_that_does_not_fit) {
+    TestDriver driver;
+    InSequence s;
+
+    // After 6 taps, only 2 bytes are left: B doesn't fit, and the repeated
+    // C that would fit must not be recorded after it
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_rec1);
+    tap_keys(key_a, key_b, key_c, key_a, key_b, key_c, key_b, key_c);
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, macros_are_loaded_from_nvm) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_rec1);
+    tap_key(key_b);
+    tap_key(key_stop);
+    tap_key(key_rec2);
+    tap_key(key_c);
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(nvm_dynamic_macro_read_length(0), 5);
+    EXPECT_EQ(nvm_dynamic_macro_read_length(1), 5);
+
+    dynamic_macro_init();
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play1);
+    tap_key(key_play2);
+    VERIFY_AND_CLEAR(driver);
+
+    // Macro 1 is empty once NVM says so
+    nvm_dynamic_macro_update_length(0, 0);
+    dynamic_macro_init();
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_play1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, truncated_events_are_not_played) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_rec1);
+    tap_key(key_a);
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    // The press of A takes four bytes, cut it off
+    nvm_dynamic_macro_update_length(0, 3);
+    dynamic_macro_init();
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_play1);
+    VERIFY_AND_CLEAR(driver);
+
+    // Keep the press, released when the playback ends
+    nvm_dynamic_macro_update_length(0, 4);
+    dynamic_macro_init();
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play1);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,141 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "event_queue.h"
+#include "timer.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class EventQueue : public TestFixture {};
+
+static keyevent_t key_event(KeymapKey key, bool pressed, uint16_t time) {
+    keyevent_t event = {};
+    event.key        = key.position;
+    event.pressed    = pressed;
+    event.time       = time;
+    event.type       = KEY_EVENT;
+    return event;
+}
+
+TEST_F(EventQueue, KeysAreProcessedInTheSameScan) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(event_queue_count(), 0);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(EventQueue, FullQueueLeavesChangesToTheNextScan) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 2, 0, KC_C);
+    auto       key_d = KeymapKey(0, 3, 0, KC_D);
+    auto       key_e = KeymapKey(0, 4, 0, KC_E);
+    auto       key_f = KeymapKey(0, 5, 0, KC_F);
+
+    set_keymap({key_a, key_b, key_c, key_d, key_e, key_f});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D));
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    key_d.press();
+    key_e.press();
+    key_f.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E, KC_F));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B, KC_C, KC_D, KC_E, KC_F));
+    EXPECT_REPORT(driver, (KC_C, KC_D, KC_E, KC_F));
+    EXPECT_REPORT(driver, (KC_D, KC_E, KC_F));
+    EXPECT_REPORT(driver, (KC_E, KC_F));
+    EXPECT_REPORT(driver, (KC_F));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    key_d.release();
+    key_e.release();
+    key_f.release();
+    idle_for(2);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(EventQueue, PushFailsWhenFull) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    for (uint8_t i = 0; i < EVENT_QUEUE_SIZE / 2; i++) {
+        EXPECT_TRUE(event_queue_push(key_event(key_a, true, timer_read())));
+        EXPECT_TRUE(event_queue_push(key_event(key_a, false, timer_read())));
+    }
+    EXPECT_FALSE(event_queue_push(key_event(key_a, true, timer_read())));
+    EXPECT_EQ(event_queue_count(), EVENT_QUEUE_SIZE);
+
+    for (uint8_t i = 0; i < EVENT_QUEUE_SIZE / 2; i++) {
+        EXPECT_REPORT(driver, (KC_A));
+        EXPECT_EMPTY_REPORT(driver);
+    }
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(event_queue_count(), 0);
+}
+
+TEST_F(EventQueue, InjectedTimestampsDecideTapOrHold) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_mt = KeymapKey(0, 0, 0, LSFT_T(KC_P));
+
+    set_keymap({key_mt});
+
+    // Both events are processed in the same scan, only their times differ
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    const uint16_t tap = timer_read();
+    event_queue_push(key_event(key_mt, true, tap));
+    event_queue_push(key_event(key_mt, false, tap + TAPPING_TERM - 1));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    idle_for(TAPPING_TERM);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    const uint16_t hold = timer_read();
+    event_queue_push(key_event(key_mt, true, hold));
+    event_queue_push(key_event(key_mt, false, hold + TAPPING_TERM));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,14 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+const key_override_t shift_bspc_override = ko_make_basic(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
+const key_override_t ctrl_shift_a        = ko_make_basic(MOD_MASK_CS, KC_A, KC_C);
+const key_override_t alt_z               = ko_make_basic(MOD_MASK_ALT, KC_Z, KC_Y);
+const key_override_t ctrl_a              = ko_make_basic(MOD_MASK_CTRL, KC_A, KC_B);
+const key_override_t gui_only            = ko_make_basic(MOD_BIT(KC_RGUI), KC_NO, KC_F);
+
+// Triggers out of order on purpose
+const key_override_t *key_overrides[] = {
+    &shift_bspc_override, &ctrl_shift_a, &alt_z, &ctrl_a, &gui_only,
+};
@@ -0,0 +1,99 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "eeconfig.h"
+#include "keycode_config.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class KeycodeConfig : public TestFixture {
+   protected:
+    void TearDown() override {
+        keymap_config.raw = 0;
+        eeconfig_update_keymap(&keymap_config);
+    }
+};
+
+TEST_F(KeycodeConfig, MagicKeycodeSwapIsSeen) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_caps = KeymapKey(0, 0, 0, KC_CAPS);
+    auto       key_swap = KeymapKey(0, 1, 0, CL_SWAP);
+    auto       key_norm = KeymapKey(0, 2, 0, CL_NORM);
+
+    set_keymap({key_caps, key_swap, key_norm});
+
+    EXPECT_REPORT(driver, (KC_CAPS));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_caps);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_swap);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LCTL));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_caps);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_norm);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_CAPS));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_caps);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeycodeConfig, ModsAreRemapped) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ctrl_a = KeymapKey(0, 0, 0, LCTL(KC_A));
+
+    set_keymap({key_ctrl_a});
+
+    keymap_config.swap_lctl_lgui = true;
+    eeconfig_update_keymap(&keymap_config);
+
+    EXPECT_REPORT(driver, (KC_LGUI));
+    EXPECT_REPORT(driver, (KC_LGUI, KC_A));
+    EXPECT_REPORT(driver, (KC_LGUI));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_ctrl_a);
+    VERIFY_AND_CLEAR(driver);
+
+    keymap_config.no_gui = true;
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_ctrl_a);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeycodeConfig, TableMatchesSwapFlags) {
+    keymap_config.raw = 0;
+    EXPECT_EQ(keycode_config(KC_GRV), KC_GRV);
+    EXPECT_EQ(keycode_config(KC_LOCKING_CAPS_LOCK), KC_LOCKING_CAPS_LOCK);
+    EXPECT_EQ(keycode_config(KC_RGUI), KC_RGUI);
+    EXPECT_EQ(mod_config(MOD_RALT), MOD_RALT);
+
+    keymap_config.swap_grave_esc = true;
+    keymap_config.swap_escape_capslock = true;
+    keymap_config.swap_ralt_rgui = true;
+    EXPECT_EQ(keycode_config(KC_GRV), KC_ESC);
+    EXPECT_EQ(keycode_config(KC_ESC), KC_GRV);
+    EXPECT_EQ(keycode_config(KC_LOCKING_CAPS_LOCK), KC_ESC);
+    EXPECT_EQ(keycode_config(KC_RGUI), KC_RALT);
+    EXPECT_EQ(keycode_config(QK_BOOT), QK_BOOT);
+    EXPECT_EQ(mod_config(MOD_RALT), MOD_RGUI);
+    EXPECT_EQ(mod_config(MOD_RCTL), MOD_RCTL);
+}
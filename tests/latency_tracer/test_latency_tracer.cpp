@@ -0,0 +1,157 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "latency_tracer.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class LatencyTracer : public TestFixture {
+   protected:
+    void SetUp() override {
+        TestFixture::SetUp();
+        latency_tracer_reset();
+    }
+
+    static void expect_latency_between(latency_path_t path, uint32_t min_us, uint32_t max_us) {
+        const latency_stats_t *stats = latency_tracer_get_path_stats(path);
+        ASSERT_GT(stats->count, 0);
+        EXPECT_GE(stats->min, min_us);
+        EXPECT_LE(stats->max, max_us);
+    }
+};
+
+TEST_F(LatencyTracer, PlainKeyIsReportedInTheSameScan) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_q = KeymapKey(0, 0, 0, KC_Q);
+
+    set_keymap({key_q});
+
+    EXPECT_REPORT(driver, (KC_Q));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_q);
+    VERIFY_AND_CLEAR(driver);
+
+    expect_latency_between(LATENCY_PATH_PLAIN, 0, 0);
+    EXPECT_EQ(latency_tracer_get_path_stats(LATENCY_PATH_PLAIN)->count, 2);
+    EXPECT_EQ(latency_tracer_get_stage_stats(LATENCY_STAGE_ACTION_EXEC)->count, 2);
+    EXPECT_EQ(latency_tracer_get_stage_stats(LATENCY_STAGE_REPORT)->count, 2);
+}
+
+TEST_F(LatencyTracer, ModTapIsDelayedUntilRelease) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_mt = KeymapKey(0, 0, 0, LSFT_T(KC_P));
+
+    set_keymap({key_mt});
+
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    key_mt.press();
+    idle_for(50);
+    key_mt.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // The tap is sent when the release resolves it, the release itself is immediate
+    expect_latency_between(LATENCY_PATH_MOD_TAP, 0, 51 * 1000);
+    EXPECT_GE(latency_tracer_get_path_stats(LATENCY_PATH_MOD_TAP)->max, 50 * 1000);
+}
+
+TEST_F(LatencyTracer, ComboIsReportedWithinComboTerm) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+
+    set_keymap({key_a, key_b});
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_a, key_b});
+    VERIFY_AND_CLEAR(driver);
+
+    expect_latency_between(LATENCY_PATH_COMBO, 0, COMBO_TERM * 1000);
+    EXPECT_EQ(latency_tracer_get_path_stats(LATENCY_PATH_PLAIN)->count, 0);
+}
+
+TEST_F(LatencyTracer, TapDanceIsDelayedByTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_td = KeymapKey(0, 0, 0, TD(0));
+
+    set_keymap({key_td});
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_td);
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    expect_latency_between(LATENCY_PATH_TAP_DANCE, TAPPING_TERM * 1000, (TAPPING_TERM + 2) * 1000);
+}
+
+TEST_F(LatencyTracer, DynamicMacroPlaybackIsNotRecorded) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_rec  = KeymapKey(0, 0, 0, DM_REC1);
+    auto       key_stop = KeymapKey(0, 1, 0, DM_RSTP);
+    auto       key_play = KeymapKey(0, 2, 0, DM_PLY1);
+    auto       key_q    = KeymapKey(0, 3, 0, KC_Q);
+
+    set_keymap({key_rec, key_stop, key_play, key_q});
+
+    EXPECT_REPORT(driver, (KC_Q));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_rec);
+    tap_key(key_q);
+    tap_key(key_stop);
+    idle_for(1000);
+    VERIFY_AND_CLEAR(driver);
+
+    latency_tracer_reset();
+
+    EXPECT_REPORT(driver, (KC_Q));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_play);
+    VERIFY_AND_CLEAR(driver);
+
+    // Only the play key itself is traced, the replayed Q has no timestamp
+    EXPECT_EQ(latency_tracer_get_stage_stats(LATENCY_STAGE_ACTION_EXEC)->count, 2);
+    EXPECT_EQ(latency_tracer_get_stage_stats(LATENCY_STAGE_PROCESS_RECORD)->count, 2);
+    EXPECT_LE(latency_tracer_get_stage_stats(LATENCY_STAGE_PROCESS_RECORD)->max, 1000);
+    EXPECT_LE(latency_tracer_get_path_stats(LATENCY_PATH_PLAIN)->max, 1000);
+}
+
+TEST_F(LatencyTracer, HistogramMatchesCount) {
+    TestDriver driver;
+    auto       key_q = KeymapKey(0, 0, 0, KC_Q);
+
+    set_keymap({key_q});
+
+    EXPECT_REPORT(driver, (KC_Q));
+    EXPECT_EMPTY_REPORT(driver);
+    key_q.press();
+    run_one_scan_loop();
+    idle_for(10);
+    key_q.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    for (uint8_t stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        const latency_stats_t *stats = latency_tracer_get_stage_stats((latency_stage_t)stage);
+        uint32_t               total = 0;
+        for (uint8_t i = 0; i < LATENCY_TRACER_HISTOGRAM_BUCKETS; i++) {
+            total += stats->histogram[i];
+        }
+        EXPECT_EQ(total, stats->count);
+    }
+}
@@ -0,0 +1,29 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+const uint16_t PROGMEM ab_sequence[]      = {KC_A, KC_B, LEADER_SEQUENCE_END};
+const uint16_t PROGMEM abc_sequence[]     = {KC_A, KC_B, KC_C, LEADER_SEQUENCE_END};
+const uint16_t PROGMEM defghij_sequence[] = {KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, LEADER_SEQUENCE_END};
+const uint16_t PROGMEM x_sequence[]       = {KC_X, LEADER_SEQUENCE_END};
+
+// Not sorted on purpose
+const leader_sequence_t PROGMEM leader_sequences[] = {
+    LEADER_SEQUENCE(defghij_sequence, KC_3),
+    LEADER_SEQUENCE(abc_sequence, KC_2),
+    LEADER_SEQUENCE_ACTION(x_sequence),
+    LEADER_SEQUENCE(ab_sequence, KC_1),
+};
+
+void leader_sequence_matched_user(uint16_t index) {
+    if (index == 2) {
+        tap_code(KC_4);
+    }
+}
+
+uint8_t leader_keys_added = 0;
+
+bool leader_add_user(uint16_t keycode) {
+    leader_keys_added++;
+    return false;
+}
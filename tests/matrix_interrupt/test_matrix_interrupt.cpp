@@ -0,0 +1,102 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class MatrixInterrupt : public TestFixture {};
+
+TEST_F(MatrixInterrupt, ParksAfterIdleTimeout) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    // Let any activity from the previous test settle so every test starts parked
+    idle_for(MATRIX_INTERRUPT_IDLE_TIMEOUT + 1);
+
+    EXPECT_TRUE(matrix_interrupt_is_armed());
+
+    matrix_interrupt_signal();
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    EXPECT_FALSE(matrix_interrupt_is_armed());
+    VERIFY_AND_CLEAR(driver);
+
+    // Held keys keep the matrix scanning
+    EXPECT_NO_REPORT(driver);
+    idle_for(MATRIX_INTERRUPT_IDLE_TIMEOUT * 2);
+    EXPECT_FALSE(matrix_interrupt_is_armed());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(MATRIX_INTERRUPT_IDLE_TIMEOUT - 2);
+    EXPECT_FALSE(matrix_interrupt_is_armed());
+    idle_for(2);
+    EXPECT_TRUE(matrix_interrupt_is_armed());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixInterrupt, PressIsIgnoredUntilSignalled) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    // Let any activity from the previous test settle so every test starts parked
+    idle_for(MATRIX_INTERRUPT_IDLE_TIMEOUT + 1);
+
+    EXPECT_NO_REPORT(driver);
+    key_a.press();
+    idle_for(5);
+    EXPECT_TRUE(matrix_interrupt_is_armed());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    matrix_interrupt_signal();
+    run_one_scan_loop();
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixInterrupt, WakeToReportLatency) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a       = KeymapKey(0, 0, 0, KC_A);
+    uint32_t   report_time = 0;
+
+    set_keymap({key_a});
+
+    // Let any activity from the previous test settle so every test starts parked
+    idle_for(MATRIX_INTERRUPT_IDLE_TIMEOUT + 1);
+
+    const uint32_t wake_count = matrix_interrupt_wake_count();
+
+    EXPECT_REPORT(driver, (KC_A)).WillOnce([&](report_keyboard_t&) { report_time = timer_read32(); });
+    key_a.press();
+    matrix_interrupt_signal();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(matrix_interrupt_wake_count(), wake_count + 1);
+    EXPECT_LE(report_time - matrix_interrupt_last_wake(), 1);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,85 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "quantum.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class ProcessRecordDispatch : public TestFixture {};
+
+TEST_F(ProcessRecordDispatch, RangeHandlersStillConsumeTheirKeycodes) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_lower = KeymapKey(0, 0, 0, TL_LOWR);
+    auto       key_dt_up = KeymapKey(0, 1, 0, DT_UP);
+    auto       key_grave = KeymapKey(0, 2, 0, QK_GESC);
+    auto       key_pdf   = KeymapKey(0, 3, 0, PDF(2));
+
+    set_keymap({key_lower, key_dt_up, key_grave, key_pdf});
+
+    EXPECT_NO_REPORT(driver);
+    key_lower.press();
+    run_one_scan_loop();
+    EXPECT_TRUE(layer_state_is(1));
+    key_lower.release();
+    run_one_scan_loop();
+    EXPECT_FALSE(layer_state_is(1));
+    VERIFY_AND_CLEAR(driver);
+
+    const uint16_t tapping_term = g_tapping_term;
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_dt_up);
+    EXPECT_EQ(g_tapping_term, tapping_term + DYNAMIC_TAPPING_TERM_INCREMENT);
+    g_tapping_term = tapping_term;
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_ESC));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_grave);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_pdf);
+    EXPECT_EQ(default_layer_state, (layer_state_t)1 << 2);
+    default_layer_set((layer_state_t)1 << 0);
+    VERIFY_AND_CLEAR(driver);
+}
+
+static double dispatch_cost(uint16_t keycode) {
+    constexpr int iterations = 200000;
+    keyrecord_t   record     = {};
+    volatile bool sink       = false;
+
+    // A preset keycode skips the keymap lookup, so that only the handler chain is timed
+    record.keycode    = keycode;
+    record.event.type = KEY_EVENT;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        record.event.pressed = !(i & 1);
+        sink         = process_record_quantum(&record);
+    }
+    auto end = std::chrono::steady_clock::now();
+    (void)sink;
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+TEST_F(ProcessRecordDispatch, Benchmark) {
+    const double basic_ns   = dispatch_cost(KC_A);
+    const double quantum_ns = dispatch_cost(QK_QUANTUM_MAX);
+
+    test_logger.info() << "process_record_quantum per event: basic keycode " << basic_ns << "ns, unused quantum keycode " << quantum_ns << "ns" << std::endl;
+    RecordProperty("basic_ns", std::to_string(basic_ns));
+    RecordProperty("quantum_ns", std::to_string(quantum_ns));
+}
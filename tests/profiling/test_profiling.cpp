@@ -0,0 +1,88 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "profiling.h"
+}
+
+using testing::_;
+
+class Profiling : public TestFixture {
+   public:
+    void SetUp() override {
+        profiling_reset();
+    }
+
+    static uint32_t histogram_total(const profiling_stats_t *stats) {
+        uint32_t total = 0;
+        for (uint8_t i = 0; i < PROFILING_HISTOGRAM_BUCKETS; i++) {
+            total += stats->histogram[i];
+        }
+        return total;
+    }
+};
+
+TEST_F(Profiling, CoreSectionsAreRecorded) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(10);
+    VERIFY_AND_CLEAR(driver);
+
+    for (uint8_t section : {PROFILING_SECTION_KEYBOARD_TASK, PROFILING_SECTION_MATRIX_TASK, PROFILING_SECTION_QUANTUM_TASK}) {
+        const profiling_stats_t *stats = profiling_get_stats(section);
+        ASSERT_NE(stats, nullptr);
+        EXPECT_EQ(stats->count, 10) << profiling_get_name(section);
+        EXPECT_LE(stats->min, profiling_get_mean(section));
+        EXPECT_LE(profiling_get_mean(section), stats->max);
+        EXPECT_EQ(histogram_total(stats), stats->count);
+    }
+
+    // keyboard_task encloses the others
+    EXPECT_GE(profiling_get_stats(PROFILING_SECTION_KEYBOARD_TASK)->total, profiling_get_stats(PROFILING_SECTION_MATRIX_TASK)->total + profiling_get_stats(PROFILING_SECTION_QUANTUM_TASK)->total);
+
+    // Features that are not enabled are never entered
+    EXPECT_EQ(profiling_get_stats(PROFILING_SECTION_RGB_MATRIX_TASK)->count, 0);
+}
+
+TEST_F(Profiling, RecordBucketsAndExtremes) {
+    profiling_record(PROFILING_SECTION_OLED_TASK, 3);
+    profiling_record(PROFILING_SECTION_OLED_TASK, 5);
+    profiling_record(PROFILING_SECTION_OLED_TASK, 100);
+
+    const profiling_stats_t *stats = profiling_get_stats(PROFILING_SECTION_OLED_TASK);
+    EXPECT_EQ(stats->count, 3);
+    EXPECT_EQ(stats->min, 3);
+    EXPECT_EQ(stats->max, 100);
+    EXPECT_EQ(profiling_get_mean(PROFILING_SECTION_OLED_TASK), 36);
+    EXPECT_EQ(stats->histogram[0], 1);
+    EXPECT_EQ(stats->histogram[1], 1);
+    EXPECT_EQ(stats->histogram[3], 1);
+
+    profiling_reset();
+    EXPECT_EQ(stats->count, 0);
+    EXPECT_EQ(histogram_total(stats), 0);
+}
+
+TEST_F(Profiling, UserSections) {
+    const uint8_t first  = profiling_register_section("first");
+    const uint8_t second = profiling_register_section("second");
+
+    EXPECT_EQ(first, PROFILING_SECTION_USER);
+    EXPECT_EQ(second, PROFILING_SECTION_USER + 1);
+    EXPECT_EQ(profiling_register_section("third"), PROFILING_SECTION_INVALID);
+    EXPECT_STREQ(profiling_get_name(second), "second");
+
+    profiling_start(first);
+    profiling_stop(first);
+    EXPECT_EQ(profiling_get_stats(first)->count, 1);
+
+    // Unknown sections are ignored
+    profiling_record(PROFILING_SECTION_INVALID, 1);
+    EXPECT_EQ(profiling_get_stats(PROFILING_SECTION_INVALID), nullptr);
+}
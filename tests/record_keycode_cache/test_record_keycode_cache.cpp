@@ -0,0 +1,103 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "quantum.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class RecordKeycodeCache : public TestFixture {};
+
+static keyrecord_t press_record(KeymapKey key) {
+    keyrecord_t record   = {};
+    record.event.key     = key.position;
+    record.event.pressed = true;
+    record.event.type    = KEY_EVENT;
+    return record;
+}
+
+TEST_F(RecordKeycodeCache, KeycodeIsKeptUntilCleared) {
+    auto        key_a  = KeymapKey(0, 0, 0, KC_A);
+    keyrecord_t record = press_record(key_a);
+
+    set_keymap({key_a});
+    EXPECT_EQ(get_record_keycode(&record, true), KC_A);
+
+    // The keymap changing doesn't change the layer state, so needs an explicit clear
+    set_keymap({KeymapKey(0, 0, 0, KC_B)});
+    EXPECT_EQ(get_record_keycode(&record, true), KC_A);
+    EXPECT_EQ(get_record_keycode(&record, false), KC_A);
+
+    clear_record_keycode_cache(&record);
+    EXPECT_EQ(get_record_keycode(&record, true), KC_B);
+}
+
+TEST_F(RecordKeycodeCache, LayerChangeIsSeen) {
+    auto        key_a  = KeymapKey(0, 0, 0, KC_A);
+    auto        key_b  = KeymapKey(1, 0, 0, KC_B);
+    keyrecord_t record = press_record(key_a);
+
+    set_keymap({key_a, key_b});
+    EXPECT_EQ(get_record_keycode(&record, true), KC_A);
+
+    layer_on(1);
+    EXPECT_EQ(get_record_keycode(&record, true), KC_B);
+
+    // A release resolves against the layer its press was resolved on
+    record.event.pressed = false;
+    layer_off(1);
+    EXPECT_EQ(get_record_keycode(&record, true), KC_B);
+}
+
+TEST_F(RecordKeycodeCache, UpdatingLookupIsNotAnsweredByReadOnlyOne) {
+    auto        key_a  = KeymapKey(0, 0, 0, KC_A);
+    auto        key_b  = KeymapKey(1, 0, 0, KC_B);
+    keyrecord_t record = press_record(key_a);
+
+    set_keymap({key_a, key_b});
+    EXPECT_EQ(get_record_keycode(&record, true), KC_A);
+
+    // The source layers cache now holds layer 0 for this key
+    keyrecord_t next = press_record(key_a);
+    layer_on(1);
+    EXPECT_EQ(get_record_keycode(&next, false), KC_A);
+    EXPECT_EQ(get_record_keycode(&next, true), KC_B);
+    EXPECT_EQ(get_record_keycode(&next, false), KC_B);
+    layer_off(1);
+}
+
+TEST_F(RecordKeycodeCache, BufferedKeyResolvesOnHeldLayer) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_lt = KeymapKey(0, 0, 0, LT(1, KC_A));
+    auto       key_c  = KeymapKey(0, 1, 0, KC_C);
+    auto       key_d  = KeymapKey(1, 1, 0, KC_D);
+
+    set_keymap({key_lt, key_c, key_d, KeymapKey(1, 0, 0, KC_TRNS)});
+
+    EXPECT_NO_REPORT(driver);
+    key_lt.press();
+    run_one_scan_loop();
+    key_c.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // The buffered press was looked up on layer 0, and is processed once layer 1 is on
+    EXPECT_REPORT(driver, (KC_D));
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_c.release();
+    run_one_scan_loop();
+    key_lt.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
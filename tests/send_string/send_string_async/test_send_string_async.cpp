@@ -0,0 +1,173 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "send_string.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+static int  callback_count;
+static bool callback_completed;
+
+extern "C" bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (keycode == QK_USER && record->event.pressed) {
+        send_string_async_cancel();
+        return false;
+    }
+    return true;
+}
+
+static void on_done(bool completed, void *cb_arg) {
+    callback_count++;
+    callback_completed = completed;
+    EXPECT_EQ(cb_arg, &callback_count);
+}
+
+class SendStringAsync : public TestFixture {
+   public:
+    void SetUp() override {
+        callback_count     = 0;
+        callback_completed = false;
+    }
+};
+
+TEST_F(SendStringAsync, typed_from_the_main_loop) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    EXPECT_TRUE(send_string_async_with_delay("ab", 0, on_done, &callback_count));
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_TRUE(send_string_async_is_active());
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(5);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_FALSE(send_string_async_is_active());
+    EXPECT_EQ(callback_count, 1);
+    EXPECT_TRUE(callback_completed);
+}
+
+TEST_F(SendStringAsync, delays_do_not_block) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string_async("a" SS_DELAY(50) "b");
+    idle_for(20);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(20);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(20);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_FALSE(send_string_async_is_active());
+}
+
+TEST_F(SendStringAsync, strings_are_queued) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_ENT));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_TRUE(send_string_async("A"));
+    EXPECT_TRUE(send_string_async_with_delay("\n", 0, on_done, &callback_count));
+    idle_for(5);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(callback_count, 1);
+}
+
+TEST_F(SendStringAsync, cancel_releases_keys) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+    send_string_async_with_delay("AB", 10, on_done, &callback_count);
+    idle_for(12);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string_async_cancel();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_FALSE(send_string_async_is_active());
+    EXPECT_EQ(callback_count, 1);
+    EXPECT_FALSE(callback_completed);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(50);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringAsync, keys_pressed_meanwhile_wait_for_the_character) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_x(0, 0, 0, KC_X);
+    set_keymap({key_x});
+
+    send_string_async_with_delay("Ab", 5, NULL, NULL);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_REPORT(driver, (KC_X, KC_B));
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(3);
+    key_x.press();
+    idle_for(30);
+    key_x.release();
+    idle_for(50);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringAsync, key_pressed_meanwhile_cancels) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_stop(0, 0, 0, QK_USER);
+    set_keymap({key_stop});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string_async_with_delay("a" SS_DELAY(1000) "b", 0, on_done, &callback_count);
+    idle_for(20);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_FALSE(send_string_async_is_active());
+    EXPECT_EQ(callback_count, 1);
+    EXPECT_FALSE(callback_completed);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(2000);
+    VERIFY_AND_CLEAR(driver);
+}
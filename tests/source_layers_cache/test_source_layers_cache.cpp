@@ -0,0 +1,102 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <random>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "source_layers_cache.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+#define ENTRIES (MATRIX_ROWS * MATRIX_COLS)
+
+class SourceLayersCache : public TestFixture {
+   protected:
+    uint8_t bit_planes[SOURCE_LAYERS_CACHE_BIT_PLANES_SIZE(ENTRIES)] = {0};
+    uint8_t nibbles[SOURCE_LAYERS_CACHE_NIBBLES_SIZE(ENTRIES)]       = {0};
+    uint8_t bytes[SOURCE_LAYERS_CACHE_BYTES_SIZE(ENTRIES)]           = {0};
+};
+
+TEST_F(SourceLayersCache, LayoutsAgree) {
+    std::mt19937 rng(42);
+    uint8_t      expected[ENTRIES] = {0};
+
+    for (int i = 0; i < 10000; i++) {
+        const uint16_t entry = rng() % ENTRIES;
+        const uint8_t  layer = rng() % MAX_LAYER;
+
+        source_layers_cache_update_bit_planes(bit_planes, entry, layer);
+        source_layers_cache_update_nibbles(nibbles, entry, layer);
+        source_layers_cache_update_bytes(bytes, entry, layer);
+        expected[entry] = layer;
+
+        // Writing one entry must not disturb its neighbours
+        for (uint16_t check = (entry ? entry - 1 : 0); check < ENTRIES && check <= entry + 1; check++) {
+            ASSERT_EQ(source_layers_cache_read_bit_planes(bit_planes, check), expected[check]);
+            ASSERT_EQ(source_layers_cache_read_nibbles(nibbles, check), expected[check]);
+            ASSERT_EQ(source_layers_cache_read_bytes(bytes, check), expected[check]);
+        }
+    }
+
+    for (uint16_t entry = 0; entry < ENTRIES; entry++) {
+        EXPECT_EQ(source_layers_cache_read_bit_planes(bit_planes, entry), expected[entry]);
+        EXPECT_EQ(source_layers_cache_read_nibbles(nibbles, entry), expected[entry]);
+        EXPECT_EQ(source_layers_cache_read_bytes(bytes, entry), expected[entry]);
+    }
+}
+
+TEST_F(SourceLayersCache, ReleaseUsesSourceLayer) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(1, 0, 0, KC_B);
+
+    set_keymap({key_a, key_b});
+
+    EXPECT_REPORT(driver, (KC_B));
+    layer_on(1);
+    key_b.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    layer_off(1);
+    key_b.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+template <typename Update, typename Read>
+static double benchmark(uint8_t *cache, Update update, Read read) {
+    constexpr int iterations = 1000000;
+    volatile uint8_t sink    = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        const uint16_t entry = (i * 7) % ENTRIES;
+        update(cache, entry, i % MAX_LAYER);
+        sink = sink + read(cache, entry);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+TEST_F(SourceLayersCache, Benchmark) {
+    const double bit_planes_ns = benchmark(bit_planes, source_layers_cache_update_bit_planes, source_layers_cache_read_bit_planes);
+    const double nibbles_ns    = benchmark(nibbles, source_layers_cache_update_nibbles, source_layers_cache_read_nibbles);
+    const double bytes_ns      = benchmark(bytes, source_layers_cache_update_bytes, source_layers_cache_read_bytes);
+
+    test_logger.info() << "source layers cache update+read: bit planes " << bit_planes_ns << "ns, nibbles " << nibbles_ns << "ns, bytes " << bytes_ns << "ns, selected layout " << SOURCE_LAYERS_CACHE_LAYOUT << std::endl;
+    RecordProperty("bit_planes_ns", std::to_string(bit_planes_ns));
+    RecordProperty("nibbles_ns", std::to_string(nibbles_ns));
+    RecordProperty("bytes_ns", std::to_string(bytes_ns));
+}
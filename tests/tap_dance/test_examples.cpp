@@ -432,3 +432,46 @@ TEST_F(TapDance, DanceFnAdvancedWithReleaseAndFinish) {
     EXPECT_EMPTY_REPORT(driver);
     run_one_scan_loop();
 }
+
+TEST_F(TapDance, StateOnlyHeldWhileInProgress) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_esc_caps = KeymapKey{0, 1, 0, TD(TD_ESC_CAPS)};
+
+    set_keymap({key_esc_caps});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_esc_caps);
+    VERIFY_AND_CLEAR(driver);
+
+    tap_dance_state_t *state = tap_dance_get_state(TD_ESC_CAPS);
+    ASSERT_NE(state, nullptr);
+    EXPECT_EQ(state->count, 1);
+    EXPECT_EQ(TAP_DANCE_KEYCODE(state), TD(TD_ESC_CAPS));
+
+    EXPECT_REPORT(driver, (KC_ESC));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM + 1);
+    VERIFY_AND_CLEAR(driver);
+
+    /* The state was freed on reset */
+    EXPECT_EQ(tap_dance_get_state(TD_ESC_CAPS), nullptr);
+}
+
+TEST_F(TapDance, GetStateDoesNotHoldState) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_esc_caps = KeymapKey{0, 1, 0, TD(TD_ESC_CAPS)};
+
+    set_keymap({key_esc_caps});
+
+    for (uint8_t i = 0; i <= TAP_DANCE_MAX_SIMULTANEOUS; i++) {
+        EXPECT_EQ(tap_dance_get_state(i), nullptr);
+    }
+
+    EXPECT_REPORT(driver, (KC_ESC));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_esc_caps);
+    idle_for(TAPPING_TERM + 1);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,134 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+static uint16_t tapping_term_calls = 0;
+
+extern "C" uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    tapping_term_calls++;
+    return TAPPING_TERM;
+}
+
+class WaitingBuffer : public TestFixture {};
+
+TEST_F(WaitingBuffer, overflow_settles_mod_tap_key_as_held) {
+    TestDriver     driver;
+    InSequence     s;
+    auto           mod_tap_hold_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+    auto           key_a            = KeymapKey(0, 1, 0, KC_A);
+    auto           key_b            = KeymapKey(0, 2, 0, KC_B);
+    auto           key_c            = KeymapKey(0, 3, 0, KC_C);
+    auto           key_d            = KeymapKey(0, 4, 0, KC_D);
+    const uint16_t overflows        = get_waiting_buffer_overflows();
+
+    set_keymap({mod_tap_hold_key, key_a, key_b, key_c, key_d});
+
+    /* Press mod-tap-hold key and fill the waiting buffer. */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    key_a.press();
+    run_one_scan_loop();
+    key_b.press();
+    run_one_scan_loop();
+    key_c.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(get_waiting_buffer_overflows(), overflows);
+
+    /* One more key settles the mod-tap-hold key as held, nothing is lost. */
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A, KC_B));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A, KC_B, KC_C));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A, KC_B, KC_C, KC_D));
+    key_d.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(get_waiting_buffer_overflows(), overflows + 1);
+
+    /* Release all keys. */
+    EXPECT_REPORT(driver, (KC_LSFT, KC_B, KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_D));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    key_b.release();
+    run_one_scan_loop();
+    key_c.release();
+    run_one_scan_loop();
+    key_d.release();
+    run_one_scan_loop();
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(WaitingBuffer, key_typed_twice_while_waiting) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+    auto       key_a            = KeymapKey(0, 1, 0, KC_A);
+
+    set_keymap({mod_tap_hold_key, key_a});
+
+    /* Press mod-tap-hold key, then type A and press it again. */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    key_a.press();
+    run_one_scan_loop();
+    key_a.release();
+    run_one_scan_loop();
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release mod-tap-hold key within the tapping term. */
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_REPORT(driver, (KC_P, KC_A));
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_REPORT(driver, (KC_P, KC_A));
+    EXPECT_REPORT(driver, (KC_A));
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release A, whose press is no longer waiting. */
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(WaitingBuffer, tapping_term_is_looked_up_once_per_tapping_key) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_hold_key});
+
+    /* Hold mod-tap-hold key past the tapping term. */
+    EXPECT_REPORT(driver, (KC_LSFT));
+    tapping_term_calls = 0;
+    mod_tap_hold_key.press();
+    idle_for(TAPPING_TERM + 1);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(tapping_term_calls, 1);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,9 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define TASK_SCHEDULER_LOOP_BUDGET 2
+#define TASK_SCHEDULER_MAX_DEFERRALS 4
@@ -0,0 +1,132 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "task_scheduler.h"
+
+void advance_time(uint32_t ms);
+}
+
+class TaskScheduler : public TestFixture {
+   protected:
+    void SetUp() override {
+        TestFixture::SetUp();
+        task_scheduler_reset_counters();
+    }
+};
+
+TEST_F(TaskScheduler, PeriodLimitsRunRate) {
+    task_scheduler_set_period(TASK_SCHEDULER_OLED, 10);
+
+    task_scheduler_loop_begin();
+    EXPECT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_OLED));
+    task_scheduler_done(TASK_SCHEDULER_OLED);
+
+    advance_time(9);
+    task_scheduler_loop_begin();
+    EXPECT_FALSE(task_scheduler_should_run(TASK_SCHEDULER_OLED));
+
+    advance_time(1);
+    task_scheduler_loop_begin();
+    EXPECT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_OLED));
+    task_scheduler_done(TASK_SCHEDULER_OLED);
+
+    // Not being due is not a deferral
+    EXPECT_EQ(task_scheduler_get_deferrals(TASK_SCHEDULER_OLED), 0);
+
+    task_scheduler_set_period(TASK_SCHEDULER_OLED, 0);
+}
+
+TEST_F(TaskScheduler, OverrunIsCounted) {
+    task_scheduler_set_budget(TASK_SCHEDULER_RGBLIGHT, 1);
+
+    task_scheduler_loop_begin();
+    ASSERT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_RGBLIGHT));
+    advance_time(3);
+    task_scheduler_done(TASK_SCHEDULER_RGBLIGHT);
+    EXPECT_EQ(task_scheduler_get_overruns(TASK_SCHEDULER_RGBLIGHT), 1);
+
+    task_scheduler_loop_begin();
+    ASSERT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_RGBLIGHT));
+    advance_time(1);
+    task_scheduler_done(TASK_SCHEDULER_RGBLIGHT);
+    EXPECT_EQ(task_scheduler_get_overruns(TASK_SCHEDULER_RGBLIGHT), 1);
+
+    EXPECT_GE(task_scheduler_get_max_loop_time(), 3);
+}
+
+TEST_F(TaskScheduler, TaskIsDeferredWhenPassIsOverBudget) {
+    task_scheduler_loop_begin();
+    advance_time(TASK_SCHEDULER_LOOP_BUDGET);
+    EXPECT_FALSE(task_scheduler_should_run(TASK_SCHEDULER_HAPTIC));
+    EXPECT_EQ(task_scheduler_get_deferrals(TASK_SCHEDULER_HAPTIC), 1);
+
+    // Still due on the next pass
+    task_scheduler_loop_begin();
+    EXPECT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_HAPTIC));
+    task_scheduler_done(TASK_SCHEDULER_HAPTIC);
+}
+
+TEST_F(TaskScheduler, OverrunDefersTheNextTasks) {
+    task_scheduler_set_budget(TASK_SCHEDULER_RGB_MATRIX, 1);
+
+    // A frame that takes longer than its budget, and than the pass
+    task_scheduler_loop_begin();
+    ASSERT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_RGB_MATRIX));
+    advance_time(TASK_SCHEDULER_LOOP_BUDGET + 1);
+    task_scheduler_done(TASK_SCHEDULER_RGB_MATRIX);
+    EXPECT_EQ(task_scheduler_get_overruns(TASK_SCHEDULER_RGB_MATRIX), 1);
+
+    // The lower priority tasks wait for the next pass
+    EXPECT_FALSE(task_scheduler_should_run(TASK_SCHEDULER_OLED));
+    EXPECT_FALSE(task_scheduler_should_run(TASK_SCHEDULER_HAPTIC));
+    EXPECT_EQ(task_scheduler_get_deferrals(TASK_SCHEDULER_OLED), 1);
+    EXPECT_EQ(task_scheduler_get_deferrals(TASK_SCHEDULER_HAPTIC), 1);
+
+    task_scheduler_loop_begin();
+    EXPECT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_RGB_MATRIX));
+    task_scheduler_done(TASK_SCHEDULER_RGB_MATRIX);
+    EXPECT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_OLED));
+    task_scheduler_done(TASK_SCHEDULER_OLED);
+    EXPECT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_HAPTIC));
+    task_scheduler_done(TASK_SCHEDULER_HAPTIC);
+
+    EXPECT_EQ(task_scheduler_get_overruns(TASK_SCHEDULER_RGB_MATRIX), 1);
+    EXPECT_EQ(task_scheduler_get_deferrals(TASK_SCHEDULER_OLED), 1);
+}
+
+TEST_F(TaskScheduler, DeferralIsBounded) {
+    for (uint8_t i = 0; i < TASK_SCHEDULER_MAX_DEFERRALS; i++) {
+        task_scheduler_loop_begin();
+        advance_time(TASK_SCHEDULER_LOOP_BUDGET);
+        EXPECT_FALSE(task_scheduler_should_run(TASK_SCHEDULER_BATTERY));
+    }
+
+    task_scheduler_loop_begin();
+    advance_time(TASK_SCHEDULER_LOOP_BUDGET);
+    EXPECT_TRUE(task_scheduler_should_run(TASK_SCHEDULER_BATTERY));
+    task_scheduler_done(TASK_SCHEDULER_BATTERY);
+    EXPECT_EQ(task_scheduler_get_deferrals(TASK_SCHEDULER_BATTERY), TASK_SCHEDULER_MAX_DEFERRALS);
+}
+
+TEST_F(TaskScheduler, KeyReportsAreNotDeferred) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -18,14 +18,37 @@
 #include "test_matrix.h"
 #include <string.h>
 
+#ifdef MATRIX_INTERRUPT_ENABLE
+#    include "matrix_interrupt.h"
+#endif
+
 static matrix_row_t matrix[MATRIX_ROWS] = {};
 
+#ifdef MATRIX_INTERRUPT_ENABLE
+// Switch state, only latched into the matrix while it is not parked
+static matrix_row_t switches[MATRIX_ROWS] = {};
+#else
+#    define switches matrix
+#endif
+
 void matrix_init(void) {
     clear_all_keys();
     matrix_init_kb();
 }
 
 uint8_t matrix_scan(void) {
+#ifdef MATRIX_INTERRUPT_ENABLE
+    if (matrix_interrupt_should_scan()) {
+        memcpy(matrix, switches, sizeof(matrix));
+    }
+
+    bool active = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        active |= matrix[row] != 0;
+    }
+    matrix_interrupt_scan_done(active);
+#endif
+
     matrix_scan_kb();
     return 1;
 }
@@ -41,11 +64,11 @@ void matrix_init_kb(void) {}
 void matrix_scan_kb(void) {}
 
 void press_key(uint8_t col, uint8_t row) {
-    matrix[row] |= (matrix_row_t)1 << col;
+    switches[row] |= (matrix_row_t)1 << col;
 }
 
 void release_key(uint8_t col, uint8_t row) {
-    matrix[row] &= ~((matrix_row_t)1 << col);
+    switches[row] &= ~((matrix_row_t)1 << col);
 }
 
 bool matrix_is_on(uint8_t row, uint8_t col) {
@@ -54,6 +77,9 @@ bool matrix_is_on(uint8_t row, uint8_t col) {
 
 void clear_all_keys(void) {
     memset(matrix, 0, sizeof(matrix));
+#ifdef MATRIX_INTERRUPT_ENABLE
+    memset(switches, 0, sizeof(switches));
+#endif
 }
 
 void led_set(uint8_t usb_led) {}
@@ -20,6 +20,7 @@ extern "C" {
 #include "action_tapping.h"
 #include "action_util.h"
 #include "action_layer.h"
+#include "action_table.h"
 #include "debug.h"
 #include "eeconfig.h"
 #include "keyboard.h"
@@ -59,6 +60,8 @@ void TestFixture::TearDownTestCase() {}
 TestFixture::TestFixture() {
     m_this = this;
     timer_clear();
+    clear_resolved_layers_cache();
+    action_table_invalidate();
     keyrecord_t empty_keyrecord = {0};
     test_logger.info() << "tapping term is " << +GET_TAPPING_TERM(KC_TRANSPARENT, &empty_keyrecord) << "ms" << std::endl;
 }
@@ -104,6 +107,8 @@ void TestFixture::add_key(KeymapKey key) {
     }
 
     this->keymap.push_back(key);
+    clear_resolved_layers_cache();
+    action_table_invalidate();
 }
 
 void TestFixture::tap_key(KeymapKey key, unsigned delay_ms) {
@@ -131,6 +136,8 @@ void TestFixture::tap_combo(const std::vector<KeymapKey>& chord_keys, unsigned d
 
 void TestFixture::set_keymap(std::initializer_list<KeymapKey> keys) {
     this->keymap.clear();
+    clear_resolved_layers_cache();
+    action_table_invalidate();
     for (auto& key : keys) {
         add_key(key);
     }
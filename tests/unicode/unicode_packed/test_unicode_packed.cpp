@@ -0,0 +1,115 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class UnicodePacked : public TestFixture {};
+
+TEST_F(UnicodePacked, digits_share_reports) {
+    TestDriver driver;
+    InSequence s;
+
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL, KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL, KC_LEFT_SHIFT, KC_U));
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL, KC_LEFT_SHIFT));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_1));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_F, KC_6, KC_0));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_0));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_SPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    register_unicode(0x1F600); // 😀
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodePacked, windows_uses_keypad_digits) {
+    TestDriver driver;
+    InSequence s;
+
+    set_unicode_input_mode(UNICODE_MODE_WINDOWS);
+
+    // Num Lock is off in the tests, so it is toggled around the sequence
+    EXPECT_REPORT(driver, (KC_NUM_LOCK));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_KP_PLUS));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_KP_0));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_KP_3));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_A, KC_KP_8));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_NUM_LOCK));
+    EXPECT_EMPTY_REPORT(driver);
+    register_unicode(0x03A8); // Ψ
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodePacked, macos_surrogate_pair_is_sent_in_one_go) {
+    TestDriver driver;
+    InSequence s;
+
+    set_unicode_input_mode(UNICODE_MODE_MACOS);
+
+    // D83D DE00
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_D, KC_8));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_3));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_D));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_D, KC_E, KC_0));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT, KC_0));
+    EXPECT_REPORT(driver, (KC_LEFT_ALT));
+    EXPECT_EMPTY_REPORT(driver);
+    register_unicode(0x1F600); // 😀
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodePacked, held_digit_is_left_alone) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_2(0, 0, 0, KC_2);
+    set_keymap({key_2});
+
+    set_unicode_input_mode(UNICODE_MODE_WINCOMPOSE);
+
+    EXPECT_REPORT(driver, (KC_2));
+    key_2.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_2, KC_RIGHT_ALT));
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_REPORT(driver, (KC_2, KC_U));
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_REPORT(driver, (KC_2, KC_0));
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_REPORT(driver, (KC_2, KC_E));
+    EXPECT_REPORT(driver, (KC_2));
+    // The held 2 is tapped on its own
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_1));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_ENTER));
+    EXPECT_EMPTY_REPORT(driver);
+    register_unicode(0xE21); // 0E21
+    VERIFY_AND_CLEAR(driver);
+}
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "keyboard.h"
 #include "keycode.h"
 #include "host.h"
+#include "latency_tracer.h"
 #include "util.h"
 #include "debug.h"
 #include "usb_device_state.h"
@@ -142,6 +143,7 @@ void host_keyboard_send(report_keyboard_t *report) {
     report->report_id = REPORT_ID_KEYBOARD;
 #endif
     (*driver->send_keyboard)(report);
+    latency_tracer_report_queued();
 
     if (debug_keyboard) {
         dprintf("keyboard_report: %02X | ", report->mods);
@@ -158,6 +160,7 @@ void host_nkro_send(report_nkro_t *report) {
 
     report->report_id = REPORT_ID_NKRO;
     (*driver->send_nkro)(report);
+    latency_tracer_report_queued();
 
     if (debug_keyboard) {
         dprintf("nkro_report: %02X | ", report->mods);